@@ -0,0 +1,62 @@
+#include "./account_index.h"
+
+using namespace std;
+
+// Fibonacci hashing: the top bits of id * 2^64/phi pick the slot, which
+// spreads runs of nearby ids over the whole table.
+size_t AccountIndex::home(int id) const {
+    uint64_t key = static_cast<uint32_t>(id);
+    return static_cast<size_t>((key * 11400714819323198485ull) >> shift);
+}
+
+void AccountIndex::rehash(size_t capacity) {
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(capacity, Slot{0, EMPTY});
+
+    shift = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) --shift;
+
+    for (const auto& slot : old) {
+        if (slot.position == EMPTY) continue;
+        size_t mask = slots.size() - 1;
+        size_t i = home(slot.id);
+        while (slots[i].position != EMPTY) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+// Kept at most half full, so probes stay short.
+void AccountIndex::reserve(size_t n) {
+    size_t capacity = 16;
+    while (capacity < n * 2) capacity <<= 1;
+    if (capacity > slots.size()) rehash(capacity);
+}
+
+bool AccountIndex::insert(int id, uint32_t position) {
+    if ((count + 1) * 2 > slots.size()) {
+        rehash(slots.empty() ? 16 : slots.size() * 2);
+    }
+
+    size_t mask = slots.size() - 1;
+    size_t i = home(id);
+    while (slots[i].position != EMPTY) {
+        if (slots[i].id == id) return false;
+        i = (i + 1) & mask;
+    }
+    slots[i] = Slot{id, position};
+    count++;
+    return true;
+}
+
+int64_t AccountIndex::find(int id) const {
+    if (slots.empty()) return -1;
+
+    size_t mask = slots.size() - 1;
+    size_t i = home(id);
+    while (slots[i].position != EMPTY) {
+        if (slots[i].id == id) return slots[i].position;
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
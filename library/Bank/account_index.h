@@ -0,0 +1,43 @@
+#ifndef ACCOUNT_INDEX_H
+#define ACCOUNT_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Open-addressing hash from account id to a position in the bank's account
+// list. Slots sit in one flat array and collisions probe linearly, so a
+// lookup is usually a single cache line. Accounts are never removed, so
+// there are no tombstones.
+class AccountIndex {
+private:
+    struct Slot {
+        int id;
+        uint32_t position;   // EMPTY when the slot is free
+    };
+
+    static const uint32_t EMPTY = UINT32_MAX;
+
+    vector<Slot> slots;
+    size_t count = 0;
+    int shift = 64;
+
+    size_t home(int id) const;
+    void rehash(size_t capacity);
+
+public:
+    // Sizes the table for n ids without growing on the way there.
+    void reserve(size_t n);
+
+    // False, and no change, when the id is already indexed.
+    bool insert(int id, uint32_t position);
+
+    // Position of the id, or -1.
+    int64_t find(int id) const;
+
+    size_t size() const { return count; }
+};
+
+#endif // ACCOUNT_INDEX_H
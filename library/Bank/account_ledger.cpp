@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "./account_ledger.h"
+
+using namespace std;
+
+void AccountLedger::post(chrono::system_clock::time_point time, double credit, double debit) {
+    if (times.empty() || times.back() <= time) {
+        times.push_back(time);
+        credits.push_back(credits.back() + credit);
+        debits.push_back(debits.back() + debit);
+        return;
+    }
+
+    size_t at = static_cast<size_t>(upper_bound(times.begin(), times.end(), time) - times.begin());
+    times.insert(times.begin() + static_cast<ptrdiff_t>(at), time);
+    credits.insert(credits.begin() + static_cast<ptrdiff_t>(at) + 1, credits[at] + credit);
+    debits.insert(debits.begin() + static_cast<ptrdiff_t>(at) + 1, debits[at] + debit);
+    for (size_t i = at + 2; i < credits.size(); ++i) {
+        credits[i] += credit;
+        debits[i] += debit;
+    }
+}
+
+double AccountLedger::netFlow(chrono::system_clock::time_point from, chrono::system_clock::time_point to) const {
+    if (to < from) return 0.0;
+    size_t first = static_cast<size_t>(lower_bound(times.begin(), times.end(), from) - times.begin());
+    size_t last = static_cast<size_t>(upper_bound(times.begin(), times.end(), to) - times.begin());
+    return (credits[last] - credits[first]) - (debits[last] - debits[first]);
+}
+
+void LedgerIndex::post(int accountId, chrono::system_clock::time_point time, const string& type, double amount) {
+    if (type == "DEPOSIT" || type == "Deposit" || type == "CREDIT") {
+        accounts[accountId].post(time, amount, 0.0);
+    } else if (type == "WITHDRAW" || type == "Withdrawal" || type == "DEBIT") {
+        accounts[accountId].post(time, 0.0, amount);
+    }
+}
+
+double LedgerIndex::netFlow(int accountId, chrono::system_clock::time_point from, chrono::system_clock::time_point to) const {
+    auto ledger = accounts.find(accountId);
+    return ledger == accounts.end() ? 0.0 : ledger->second.netFlow(from, to);
+}
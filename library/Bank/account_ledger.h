@@ -0,0 +1,44 @@
+#ifndef ACCOUNT_LEDGER_H
+#define ACCOUNT_LEDGER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+
+using namespace std;
+
+// Credits and debits of one account in time order, with running totals:
+// credits[i] and debits[i] sum the first i entries. The flow over any time
+// window is a difference of two prefixes found by binary search.
+class AccountLedger {
+private:
+    vector<chrono::system_clock::time_point> times;
+    vector<double> credits{0.0};
+    vector<double> debits{0.0};
+
+public:
+    // Entries normally arrive in time order; an older one is inserted in
+    // place and the totals after it are rebuilt.
+    void post(chrono::system_clock::time_point time, double credit, double debit);
+
+    // Credits minus debits of the entries with from <= time <= to.
+    double netFlow(chrono::system_clock::time_point from, chrono::system_clock::time_point to) const;
+
+    size_t size() const { return times.size(); }
+};
+
+// Ledgers of every account, keyed by account id.
+class LedgerIndex {
+private:
+    unordered_map<int, AccountLedger> accounts;
+
+public:
+    // Types written by this program are DEPOSIT and WITHDRAW; the others
+    // appear in older files. Unknown types are ignored.
+    void post(int accountId, chrono::system_clock::time_point time, const string& type, double amount);
+
+    double netFlow(int accountId, chrono::system_clock::time_point from, chrono::system_clock::time_point to) const;
+};
+
+#endif // ACCOUNT_LEDGER_H
@@ -1,53 +1,145 @@
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
-#include <map>
 #include <chrono>
 #include <limits>
-#include <ctime>
 
 #include "./bank.h"
 #include "./bank_customer.h"
+#include "../Serialization/serialization.h"
+#include "../Serialization/civil_time.h"
 
 using namespace std;
 using namespace chrono;
 
+// Called once per printed row, so it skips the shared_ptr copy.
 string Bank::getCustomerNameById(int id) const {
-    auto customer = findAccount(id);
-    return customer ? customer->getName() : "Unknown User";
+    int64_t position = accountIndex.find(id);
+    return position >= 0 ? accounts[static_cast<size_t>(position)]->getName() : "Unknown User";
 }
 
 Bank::Bank(const string& name) {
     this->name = name;
+    this->ledgersBuilt = false;
+    this->entriesBuilt = false;
+    this->dormancyBuilt = false;
     this->customerCount = 0;
 }
 
+// Transactions nearly always arrive in time order; an older one is
+// inserted in place so the log stays sorted.
+void Bank::append(const TransactionRecord& record) {
+    if (transactions.empty() || transactions.back().transactionTime <= record.transactionTime) {
+        transactions.push_back(record);
+        if (entriesBuilt) entries[record.accountId].push_back(static_cast<uint32_t>(transactions.size() - 1));
+    } else {
+        auto at = upper_bound(transactions.begin(), transactions.end(), record.transactionTime,
+                              [](system_clock::time_point time, const TransactionRecord& r) {
+                                  return time < r.transactionTime;
+                              });
+        transactions.insert(at, record);
+        entriesBuilt = false;
+    }
+    if (ledgersBuilt) {
+        ledgers.post(record.accountId, record.transactionTime, record.type, record.amount);
+    }
+    todayCounts.record(record.accountId, record.transactionTime);
+}
+
+vector<TransactionRecord>::const_iterator Bank::firstSince(system_clock::time_point time) const {
+    return partition_point(transactions.begin(), transactions.end(),
+                           [time](const TransactionRecord& r) { return r.transactionTime < time; });
+}
+
+void Bank::post(const BankTransaction& t) {
+    saveTransaction(t, TRANSACTIONS_FILE);
+    todayCounts.advance(system_clock::now());
+    append({t.accountId, symbols.intern(t.description), t.amount, t.type, t.timestamp});
+
+    // The account has already noted the activity itself.
+    int64_t position = accountIndex.find(t.accountId);
+    if (position < 0) return;
+    if (dormancyBuilt) {
+        dormancy.touch(static_cast<uint32_t>(position), toUnixSeconds(t.timestamp));
+    }
+}
+
+void Bank::restoreTransactions(const vector<BankTransaction>& rows) {
+    transactions.clear();
+    transactions.reserve(rows.size());
+    ledgers = LedgerIndex();
+    ledgersBuilt = false;
+    entries.clear();
+    entriesBuilt = false;
+    todayCounts.startDay(system_clock::now());
+    for (const auto& t : rows) {
+        if (t.accountId <= 0) continue;
+        append({t.accountId, symbols.intern(t.description), t.amount, t.type, t.timestamp});
+        if (auto account = findAccount(t.accountId)) account->noteActivity(t.timestamp);
+    }
+    dormancyBuilt = false;
+}
+
+double Bank::netFlow(int accountId, system_clock::time_point from, system_clock::time_point to) {
+    if (!ledgersBuilt) {
+        for (const auto& record : transactions) {
+            ledgers.post(record.accountId, record.transactionTime, record.type, record.amount);
+        }
+        ledgersBuilt = true;
+    }
+    return ledgers.netFlow(accountId, from, to);
+}
+
+span<const uint32_t> Bank::entriesOf(int accountId) {
+    if (!entriesBuilt) {
+        entries.clear();
+        for (size_t i = 0; i < transactions.size(); ++i) {
+            entries[transactions[i].accountId].push_back(static_cast<uint32_t>(i));
+        }
+        entriesBuilt = true;
+    }
+    auto found = entries.find(accountId);
+    if (found == entries.end()) return {};
+    return found->second;
+}
+
 void Bank::addAccount(shared_ptr<BankCustomer> newCustomer) {
     if (!newCustomer) {
         cout << "Invalid customer. Cannot add account.\n\n";
         return;
     }
 
-    if (findAccount(newCustomer->getId())) {
+    if (!registerCustomer(newCustomer)) {
         cout << "Account with ID " << newCustomer->getId() << " already exists.\n\n";
         return;
     }
 
-    accounts.push_back(newCustomer);
     customerCount++;
     cout << "Account for " << newCustomer->getName() << " added successfully.\n\n";
 }
 
-shared_ptr<BankCustomer> Bank::findAccount(int id) const {
-    auto it = find_if(accounts.begin(), accounts.end(),
-                      [id](const shared_ptr<BankCustomer>& customer) {
-                          return customer->getId() == id;
-                      });
+bool Bank::registerCustomer(shared_ptr<BankCustomer> customer) {
+    if (!customer || !accountIndex.insert(customer->getId(), static_cast<uint32_t>(accounts.size()))) {
+        return false;
+    }
+    accounts.push_back(customer);
+    if (dormancyBuilt) {
+        dormancy.touch(static_cast<uint32_t>(accounts.size() - 1), toUnixSeconds(customer->getLastTransactionTime()));
+    }
+    return true;
+}
 
-    if (it != accounts.end()) {
-        return *it;
+void Bank::reserveAccounts(size_t n) {
+    accounts.reserve(n);
+    accountIndex.reserve(n);
+}
+
+shared_ptr<BankCustomer> Bank::findAccount(int id) const {
+    int64_t position = accountIndex.find(id);
+    if (position < 0) {
+        return nullptr;
     }
-    return nullptr;
+    return accounts[static_cast<size_t>(position)];
 }
 
 void Bank::listAccounts() const {
@@ -77,14 +169,12 @@ void Bank::listRecentTransactions(int days) {
     
     bool found = false;
 
-    for (const auto& tx : transactions) {
-        if (tx.transactionTime >= timeLimit) {
-            found = true;
-            cout << "Account ID: " << setw(10) << tx.accountId
-                 << " | User: " << setw(20) << getCustomerNameById(tx.accountId)
-                 << " | Amount: Rp" << fixed << setprecision(2) << tx.amount 
-                 << " | Type: " << tx.type << "\n";
-        }
+    for (auto tx = firstSince(timeLimit); tx != transactions.end(); ++tx) {
+        found = true;
+        cout << "Account ID: " << setw(10) << tx->accountId
+             << " | User: " << setw(20) << getCustomerNameById(tx->accountId)
+             << " | Amount: Rp" << fixed << setprecision(2) << tx->amount 
+             << " | Type: " << tx->type << "\n";
     }
 
     if (!found) {
@@ -93,9 +183,10 @@ void Bank::listRecentTransactions(int days) {
     cout << "\n";
 }
 
-void Bank::listDormantAccounts() const { 
+// Oldest activity first; accounts that were never active lead the list.
+void Bank::listDormantAccounts() { 
     auto now = system_clock::now();
-    auto monthLimit = now - hours(24 * 30); 
+    int64_t monthLimit = toUnixSeconds(now - hours(24 * 30)); 
 
     cout << "\n-- DORMANT ACCOUNTS (NO ACTIVITY IN 1 MONTH) --\n";
     bool foundDormant = false;
@@ -105,46 +196,33 @@ void Bank::listDormantAccounts() const {
         return;
     }
 
-    for (const auto& customer : accounts) {
-        if (customer->getLastTransactionTime() < monthLimit) {
-            foundDormant = true;
-            cout << "ID: " << setw(10) << customer->getId()
-                 << " | Name: " << customer->getName() << "\n";
+    if (!dormancyBuilt) {
+        vector<int64_t> lastActive;
+        lastActive.reserve(accounts.size());
+        for (const auto& customer : accounts) {
+            lastActive.push_back(toUnixSeconds(customer->getLastTransactionTime()));
         }
+        dormancy.rebuild(lastActive);
+        dormancyBuilt = true;
     }
 
+    dormancy.forEachIdleSince(monthLimit, [&](uint32_t position, int64_t) {
+        const auto& customer = accounts[position];
+        foundDormant = true;
+        cout << "ID: " << setw(10) << customer->getId()
+             << " | Name: " << customer->getName() << "\n";
+    });
+
     if (!foundDormant) {
         cout << "No dormant accounts found.\n";
     }
     cout << "\n";
 }
 
-void Bank::listTopTransactingUsers(int n) const { 
+void Bank::listTopTransactingUsers(int n) { 
     if (n <= 0) return;
 
-    time_t rawtime = system_clock::to_time_t(system_clock::now());
-    tm* localTime = localtime(&rawtime);
-    
-    map<int, int> userTxCount; 
-
-    for (const auto& tx : transactions) {
-        time_t tx_rawtime = system_clock::to_time_t(tx.transactionTime);
-        tm* tx_localTime = localtime(&tx_rawtime);
-
-        if (tx_localTime->tm_mday == localTime->tm_mday &&
-            tx_localTime->tm_mon == localTime->tm_mon &&
-            tx_localTime->tm_year == localTime->tm_year) 
-        {
-            userTxCount[tx.accountId]++;
-        }
-    }
-
-    vector<pair<int, int>> sortedUsers; 
-    for (const auto& pair : userTxCount) {
-        sortedUsers.push_back({pair.second, pair.first});
-    }
-
-    sort(sortedUsers.rbegin(), sortedUsers.rend()); 
+    vector<pair<uint32_t, int>> sortedUsers = todayCounts.top(static_cast<size_t>(n), system_clock::now());
 
     cout << "\n-- TOP " << n << " TRANSACTING USERS (TODAY) --\n";
     if (sortedUsers.empty()) {
@@ -5,15 +5,27 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <span>
+#include <unordered_map>
 
 #include "./bank_customer.h"
+#include "./account_index.h"
+#include "./dormancy_index.h"
+#include "./daily_counts.h"
+#include "./account_ledger.h"
+#include "./bank_transaction.h"
+#include "../Item/symbol_table.h"
 
 class BankCustomer;
 
 using namespace std;
 
+// Where every deposit and withdrawal is saved.
+const string TRANSACTIONS_FILE = "transactions.csv";
+
 struct TransactionRecord {
     int accountId;
+    Symbol description;
     double amount;
     string type;
     chrono::system_clock::time_point transactionTime;
@@ -23,18 +35,38 @@ class Bank {
 private:
     string name;
     vector<shared_ptr<BankCustomer>> accounts;
+    AccountIndex accountIndex;
+    // Every deposit and withdrawal, oldest first: read back from the
+    // transaction file at startup and appended to as they are posted.
     vector<TransactionRecord> transactions;
+    // Per-account totals over transactions, built on the first query.
+    LedgerIndex ledgers;
+    bool ledgersBuilt;
+    // Positions in transactions of each account's entries, oldest first,
+    // built on the first history view. An entry inserted out of time order
+    // moves the ones after it, so the index is built again.
+    unordered_map<int, vector<uint32_t>> entries;
+    bool entriesBuilt;
+    // Accounts by last activity, built on the first dormancy check.
+    DormancyIndex dormancy;
+    bool dormancyBuilt;
+    // Today's transactions per account, counted as they are appended.
+    DailyCounts todayCounts;
     int customerCount;
     string getCustomerNameById(int id) const;
 
+    void append(const TransactionRecord& record);
+    // First transaction at or after the time.
+    vector<TransactionRecord>::const_iterator firstSince(chrono::system_clock::time_point time) const;
+
 public:
     Bank(const string& name);
 
     virtual ~Bank() = default;
 
-    void registerCustomer(std::shared_ptr<BankCustomer> customer) {
-        accounts.push_back(customer);
-    }
+    // Adds an account without announcing it. False when the id is taken.
+    bool registerCustomer(std::shared_ptr<BankCustomer> customer);
+    void reserveAccounts(size_t n);
 
     void addAccount(shared_ptr<BankCustomer> newCustomer);
     shared_ptr<BankCustomer> findAccount(int id) const;
@@ -43,10 +75,21 @@ public:
     string getName() const { return name; }
     int getCustomerCount() const { return customerCount; }
 
+    // Saves a deposit or withdrawal and adds it to the bank's log.
+    void post(const BankTransaction& t);
+    // Replaces the log with rows read from the transaction file, and moves
+    // each account's last activity up to its newest row.
+    void restoreTransactions(const vector<BankTransaction>& rows);
+    double netFlow(int accountId, chrono::system_clock::time_point from, chrono::system_clock::time_point to);
+
+    // Positions of the account's transactions in the log, oldest first.
+    span<const uint32_t> entriesOf(int accountId);
+    const TransactionRecord& entryAt(uint32_t position) const { return transactions[position]; }
+
     void handleAdminMenu();
     void listRecentTransactions(int days);
-    void listDormantAccounts() const;
-    void listTopTransactingUsers(int n) const;
+    void listDormantAccounts();
+    void listTopTransactingUsers(int n);
 };
 
 #endif // BANK_H
\ No newline at end of file
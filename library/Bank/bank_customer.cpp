@@ -5,28 +5,48 @@
 #include <iomanip>
 #include <chrono>
 #include <cmath>
-#include <ctime>
 
 #include "./bank_customer.h"
+#include "./bank.h"
 #include "../User/user.h"
-#include "../Item/order.h"
 #include "../Serialization/serialization.h"
+#include "../Serialization/snapshot_files.h"
+#include "../Serialization/csv_codec.h"
+#include "../Serialization/civil_time.h"
 
-extern std::vector<Order> orders;
-extern void loadOrders(std::vector<Order>&);
-extern void saveTransaction(const BankTransaction& t, const std::string& filename);
+extern Bank systemBank;
 using namespace std;
 
-shared_ptr<BankCustomer> BankCustomer::fromCSV(const vector<string>& tokens) {
+shared_ptr<BankCustomer> BankCustomer::fromCSV(span<const string_view> tokens) {
     if (tokens.size() < 3) return nullptr;
-    try {
-        int id = stoi(tokens[0]);
-        string name = tokens[1];
-        double balance = stod(tokens[2]);
-        return make_shared<BankCustomer>(id, name, balance);
-    } catch (...) {
+
+    int id;
+    double balance;
+    if (!parseNumber(tokens[0], id) || !parseNumber(tokens[2], balance)) {
         return nullptr;
     }
+    auto account = make_shared<BankCustomer>(id, string(tokens[1]), balance);
+    int64_t lastActive;
+    if (tokens.size() > 3 && parseNumber(tokens[3], lastActive) && lastActive > 0) {
+        account->noteActivity(chrono::system_clock::time_point(chrono::seconds(lastActive)));
+    }
+    return account;
+}
+
+void BankCustomer::appendCSV(string& out) const {
+    appendNumber(out, id);
+    out += ',';
+    out += name;
+    out += ',';
+    appendNumber(out, balance);
+    out += ',';
+    appendNumber(out, toUnixSeconds(lastTransactionTime));
+}
+
+string BankCustomer::toCSV() const {
+    string out;
+    appendCSV(out);
+    return out;
 }
 
 extern shared_ptr<User> currentUser;
@@ -35,6 +55,14 @@ enum BankingPrompt{
     BALANCE_CHECK, TRANSACTION_HISTORY, DEPOSIT, WITHDRAW, CASH_FLOW, BACK_BANKING
 };
 
+const size_t HISTORY_PAGE_SIZE = 10;
+
+void BankCustomer::markDirty() {
+    if (dirty) return;
+    dirty = true;
+    dirtyAccounts.mark(name);
+}
+
 // Banking functions //
 void BankCustomer::addBalance(double amount) {
     if (amount <= 0) {
@@ -42,6 +70,8 @@ void BankCustomer::addBalance(double amount) {
         return;
     }
     balance += amount;
+    markDirty();
+    logBalance(id, balance);
     cout << "Deposited: Rp" << amount << "\n\n";
     
     BankTransaction t;
@@ -51,7 +81,9 @@ void BankCustomer::addBalance(double amount) {
     t.amount = amount;
     t.description = "Self-Deposit via ATM/Menu";
 
-    saveTransaction(t, "transactions.csv");
+    noteActivity(t.timestamp);
+    systemBank.post(t);
+    recordTransaction(t);
 }
 
 bool BankCustomer::withdraw(double amount, const std::string& description) {
@@ -60,6 +92,8 @@ bool BankCustomer::withdraw(double amount, const std::string& description) {
     }
     
     balance -= amount;
+    markDirty();
+    logBalance(id, balance);
 
     BankTransaction t;
     t.timestamp = std::chrono::system_clock::now();
@@ -68,37 +102,76 @@ bool BankCustomer::withdraw(double amount, const std::string& description) {
     t.amount = amount;
     t.description = description;
 
-    saveTransaction(t, "transactions.csv");
+    noteActivity(t.timestamp);
+    systemBank.post(t);
+    recordTransaction(t);
     
     return true;
 }
 
-void BankCustomer::showTransactionHistory() const {
-    loadOrders(orders); 
-    
+void BankCustomer::recordTransaction(const BankTransaction& t) {
+    if (!historyLoaded) return;
+    if (transactionHistory.push({t.amount, t.type, t.timestamp, t.description})) olderInLog++;
+}
+
+CustomerTransaction historyEntry(const TransactionRecord& record) {
+    return {record.amount, record.type, record.transactionTime, symbols.name(record.description)};
+}
+
+// The newest entries of the bank's log fill the ring; it then follows
+// recordTransaction.
+void BankCustomer::loadHistory() {
+    span<const uint32_t> entries = systemBank.entriesOf(id);
+    size_t inMemory = min(entries.size(), TransactionHistory::defaultCapacity());
+    olderInLog = entries.size() - inMemory;
+
+    transactionHistory.clear();
+    for (size_t i = olderInLog; i < entries.size(); ++i) {
+        transactionHistory.push(historyEntry(systemBank.entryAt(entries[i])));
+    }
+    historyLoaded = true;
+}
+
+void BankCustomer::showTransactionHistory() {
+    if (!historyLoaded) loadHistory();
+
     cout << "\n--- Transaction History for Account ID: " << id << " (" << name << ") ---\n";
     cout << "Type       | Date & Time          | Amount (Rp) | Description\n";
     cout << "-----------------------------------------------------------------------\n";
 
-    bool found = false;
-    
-    for (const auto& order : orders) {
-        if (order.getBuyerName() == name && order.getStatus() == "DONE") {
-            found = true;
-            
-            time_t timeT = std::chrono::system_clock::to_time_t(order.getCreationTime());
-            tm* ltm = localtime(&timeT);
-            
-            cout << left << setw(10) << "WITHDRAWAL" 
-                 << " | " << put_time(ltm, "%Y-%m-%d %H:%M:%S") 
-                 << " | " << fixed << setprecision(2) << setw(11) << order.getTotalAmount()
-                 << " | Purchase from " << order.getSellerStoreName()
-                 << " (Order ID: " << order.getOrderId() << ")\n";
-        }
+    size_t total = transactionHistory.size() + olderInLog;
+    if (total == 0) {
+        cout << "No transactions found.\n\n";
+        return;
     }
 
-    if (!found) {
-        cout << "No completed purchase transactions found.\n";
+    // Pages are newest first; the ones past the ring come from the bank's
+    // log, whose first olderInLog entries of the account are the older ones.
+    for (size_t shown = 0; shown < total;) {
+        size_t pageEnd = min(shown + HISTORY_PAGE_SIZE, total);
+        for (; shown < pageEnd; ++shown) {
+            CustomerTransaction entry;
+            if (shown < transactionHistory.size()) {
+                entry = transactionHistory.newest(shown);
+            } else {
+                span<const uint32_t> older = systemBank.entriesOf(id);
+                size_t back = shown - transactionHistory.size();
+                if (back >= min(older.size(), olderInLog)) break;
+                entry = historyEntry(systemBank.entryAt(older[olderInLog - 1 - back]));
+            }
+
+            char time[CIVIL_TIME_LENGTH];
+            string timeText = formatLocalTime(entry.timestamp, time) ? string(time, CIVIL_TIME_LENGTH) : "UnknownTime";
+            cout << left << setw(10) << entry.type
+                 << " | " << setw(20) << timeText
+                 << " | " << fixed << setprecision(2) << setw(11) << entry.amount
+                 << " | " << entry.description << "\n";
+        }
+        if (shown < pageEnd || shown >= total) break;
+
+        string more;
+        cout << "Enter 'o' for older entries, anything else to go back: ";
+        if (!(cin >> more) || more != "o") break;
     }
     cout << "\n";
 }
@@ -109,31 +182,11 @@ void BankCustomer::printInfo() const {
             << ", Balance: Rp" << balance << "\n\n";
 }
 
+// Answered from the bank's per-account ledgers.
 double BankCustomer::calculateCashFlow(int days) const {
-    double netFlow = 0.0;
-
-    auto timeLimitDuration = chrono::hours(days * 24); 
     auto now = chrono::system_clock::now();
-    auto timeLimit = now - timeLimitDuration;
-
-    std::vector<BankTransaction> allTransactions = 
-        BankTransaction::loadFromFile("nama_file_transaksi.csv");
-
-    int currentId = this->id;
-    for (const auto& tx : allTransactions) {
-        if (tx.accountId != currentId) {
-            continue;
-        }
-
-        if (tx.timestamp >= timeLimit) {
-            if (tx.type == "Deposit" || tx.type == "CREDIT") {
-                netFlow += tx.amount;
-            } else if (tx.type == "Withdrawal" || tx.type == "DEBIT") {
-                netFlow -= tx.amount;
-            }
-        }
-    }
-    return netFlow;
+    auto timeLimit = now - chrono::hours(days * 24);
+    return systemBank.netFlow(id, timeLimit, now);
 }
 
 void BankCustomer::handleBankingFunctions() {
@@ -6,27 +6,38 @@
 #include <sstream>
 #include <memory>
 #include <vector>
+#include <span>
+#include <string_view>
 #include <chrono>
 
+#include "./transaction_history.h"
+
 using namespace std;
 
-struct CustomerTransaction {
-    double amount;
-    string type;
-    chrono::system_clock::time_point timestamp; 
-};
+class BankTransaction;
 
 class BankCustomer {
 private:
     int id;
     string name;
     double balance;
+    // Saved with the account; the epoch when it has never been active.
     chrono::system_clock::time_point lastTransactionTime;
-    vector<CustomerTransaction> transactionHistory;
+    // Newest ledger entries; the olderInLog entries before them are only
+    // in the bank's log. Filled from the log on the first history view.
+    TransactionHistory transactionHistory;
+    bool historyLoaded;
+    size_t olderInLog;
+    bool dirty;
+
+    void markDirty();
+    void loadHistory();
 
 public:
     BankCustomer(int id, const string& name, double balance)
-        : id(id), name(name), balance(balance) {}
+        : id(id), name(name), balance(balance),
+          transactionHistory(TransactionHistory::defaultCapacity()), historyLoaded(false), olderInLog(0),
+          dirty(true) {}
 
     virtual ~BankCustomer() = default;
 
@@ -34,33 +45,41 @@ public:
         return lastTransactionTime;
     }
 
-    string toCSV() const {
-        stringstream ss;
-        ss << id << "," << name << "," << balance;
-        return ss.str();
-    }
+    // Appends "id,name,balance,lastActive" to out, lastActive in unix
+    // seconds. Rows without the last column read as never active.
+    void appendCSV(string& out) const;
+    string toCSV() const;
 
-    static shared_ptr<BankCustomer> fromCSV(const vector<string>& tokens);
+    static shared_ptr<BankCustomer> fromCSV(span<const string_view> tokens);
 
-    void updateLastTransactionTime() {
-        lastTransactionTime = chrono::system_clock::now();
+    // Moves the last activity forward to the time. It does not mark the
+    // account dirty: the balance change that comes with it already does.
+    void noteActivity(chrono::system_clock::time_point time) {
+        if (time > lastTransactionTime) lastTransactionTime = time;
     }
 
     bool withdraw(double amount, const std::string& description);
 
-    void recordTransaction(double amount, const string& type);
+    // Keeps a transaction saved to the ledger in the in-memory history.
+    void recordTransaction(const BankTransaction& t);
 
     double calculateCashFlow(int days) const;
     int getId() const { return id; }
     string getName() const { return name; }
     double getBalance() const { return balance; }
 
-    void setName(const string& newName) { name = newName; }
-    void setBalance(double newBalance) { balance = newBalance; }
+    void setName(const string& newName) { name = newName; markDirty(); }
+    void setBalance(double newBalance) { balance = newBalance; markDirty(); }
+
+    // Set by every change that has to reach the snapshot files. The account
+    // is listed in dirtyAccounts when the flag is set, except for new
+    // accounts, which the user directory lists.
+    bool isDirty() const { return dirty; }
+    void clearDirty() { dirty = false; }
 
     void addBalance(double amount);
     bool withdrawBalance(double amount);
-    void showTransactionHistory() const;
+    void showTransactionHistory();
     void printInfo() const;
 
     void handleBankingFunctions();
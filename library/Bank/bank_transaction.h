@@ -1,6 +1,11 @@
+#ifndef BANK_TRANSACTION_H
+#define BANK_TRANSACTION_H
+
 #include <chrono>
 #include <string>
 #include <vector>
+#include <span>
+#include <string_view>
 
 class BankTransaction {
 public:
@@ -11,7 +16,16 @@ public:
     std::string description;
 
     static std::vector<BankTransaction> loadFromFile(const std::string& filename);
+    // Only rows in [from, to], and of accountId unless it is 0. Ledger
+    // segments outside the window are skipped without being read.
+    static std::vector<BankTransaction> loadFromFile(const std::string& filename,
+                                                     std::chrono::system_clock::time_point from,
+                                                     std::chrono::system_clock::time_point to,
+                                                     int accountId = 0);
 
+    void appendCSV(std::string& out) const;
     std::string toCSV() const;
-    static BankTransaction fromCSV(const std::vector<std::string>& tokens);
-};
\ No newline at end of file
+    static BankTransaction fromCSV(std::span<const std::string_view> tokens);
+};
+
+#endif // BANK_TRANSACTION_H
\ No newline at end of file
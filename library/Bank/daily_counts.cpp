@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+#include "daily_counts.h"
+#include "../Serialization/civil_time.h"
+
+using namespace std;
+using namespace chrono;
+
+void DailyCounts::startDay(system_clock::time_point now) {
+    rollTo(now);
+}
+
+void DailyCounts::advance(system_clock::time_point now) {
+    if (now >= dayEnd || now < dayStart) rollTo(now);
+}
+
+void DailyCounts::rollTo(system_clock::time_point time) {
+    int64_t day = localDayNumber(time);
+    dayStart = system_clock::time_point(seconds(localMidnight(day)));
+    dayEnd = system_clock::time_point(seconds(localMidnight(day + 1)));
+    counts.clear();
+}
+
+void DailyCounts::record(int accountId, system_clock::time_point time) {
+    if (time < dayStart || time >= dayEnd) return;
+    counts[accountId]++;
+}
+
+// A min-heap of n entries keeps the best seen so far, so only the printed
+// accounts are ever ordered.
+vector<pair<uint32_t, int>> DailyCounts::top(size_t n, system_clock::time_point now) {
+    advance(now);
+
+    priority_queue<pair<uint32_t, int>, vector<pair<uint32_t, int>>, greater<pair<uint32_t, int>>> best;
+    for (const auto& entry : counts) {
+        pair<uint32_t, int> candidate(entry.second, entry.first);
+        if (best.size() < n) {
+            best.push(candidate);
+        } else if (n > 0 && best.top() < candidate) {
+            best.pop();
+            best.push(candidate);
+        }
+    }
+
+    vector<pair<uint32_t, int>> ranked;
+    ranked.reserve(best.size());
+    while (!best.empty()) {
+        ranked.push_back(best.top());
+        best.pop();
+    }
+    reverse(ranked.begin(), ranked.end());
+    return ranked;
+}
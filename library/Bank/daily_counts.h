@@ -0,0 +1,41 @@
+#ifndef DAILY_COUNTS_H
+#define DAILY_COUNTS_H
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Transactions per account for one local calendar day. The bounds of the
+// day are worked out once when the bucket rolls over, so counting a
+// transaction is a time comparison and a hash increment. Only the clock
+// rolls the bucket over, never a row: a future-dated or out-of-order row
+// is simply outside the day.
+class DailyCounts {
+private:
+    chrono::system_clock::time_point dayStart;
+    chrono::system_clock::time_point dayEnd;
+    unordered_map<int, uint32_t> counts;
+
+    // Starts an empty bucket for the local day holding the time.
+    void rollTo(chrono::system_clock::time_point time);
+
+public:
+    // Empties the bucket and sets it to the local day of now.
+    void startDay(chrono::system_clock::time_point now);
+    // Starts the day of now when now is outside the current one.
+    void advance(chrono::system_clock::time_point now);
+
+    // Counts the transaction when its time is inside the current day.
+    void record(int accountId, chrono::system_clock::time_point time);
+
+    // The n accounts with the most transactions on the day of now, most
+    // first as (count, account id); ties go to the larger id.
+    vector<pair<uint32_t, int>> top(size_t n, chrono::system_clock::time_point now);
+};
+
+#endif // DAILY_COUNTS_H
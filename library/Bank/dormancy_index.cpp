@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <numeric>
+
+#include "dormancy_index.h"
+
+using namespace std;
+
+void DormancyIndex::unlink(uint32_t position) {
+    Link& link = links[position];
+    if (link.prev != NONE) links[link.prev].next = link.next; else head = link.next;
+    if (link.next != NONE) links[link.next].prev = link.prev; else tail = link.prev;
+    link.prev = link.next = NONE;
+}
+
+// Searched from the tail, where live activity lands; only accounts added
+// with an old time go further, and those older than everything go to the
+// head directly.
+void DormancyIndex::place(uint32_t position) {
+    Link& link = links[position];
+    uint32_t after = tail;
+    if (head != NONE && link.lastActive < links[head].lastActive) {
+        after = NONE;
+    } else {
+        while (after != NONE && links[after].lastActive > link.lastActive) after = links[after].prev;
+    }
+
+    link.prev = after;
+    link.next = (after == NONE) ? head : links[after].next;
+    if (link.next != NONE) links[link.next].prev = position; else tail = position;
+    if (after != NONE) links[after].next = position; else head = position;
+}
+
+// Ties keep position order, so accounts with the same time list in the
+// order they were added.
+void DormancyIndex::rebuild(const vector<int64_t>& lastActive) {
+    vector<uint32_t> order(lastActive.size());
+    iota(order.begin(), order.end(), 0u);
+    stable_sort(order.begin(), order.end(),
+                [&lastActive](uint32_t a, uint32_t b) { return lastActive[a] < lastActive[b]; });
+
+    links.assign(lastActive.size(), Link{NONE, NONE, 0});
+    head = tail = NONE;
+    for (uint32_t position : order) {
+        links[position].lastActive = lastActive[position];
+        links[position].prev = tail;
+        if (tail != NONE) links[tail].next = position; else head = position;
+        tail = position;
+    }
+}
+
+void DormancyIndex::touch(uint32_t position, int64_t lastActive) {
+    if (position >= links.size()) {
+        uint32_t first = static_cast<uint32_t>(links.size());
+        links.resize(position + 1, Link{NONE, NONE, 0});
+        links[position].lastActive = lastActive;
+        for (uint32_t added = first; added <= position; ++added) place(added);
+        return;
+    }
+    if (lastActive <= links[position].lastActive) return;
+
+    unlink(position);
+    links[position].lastActive = lastActive;
+    place(position);
+}
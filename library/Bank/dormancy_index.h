@@ -0,0 +1,53 @@
+#ifndef DORMANCY_INDEX_H
+#define DORMANCY_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Accounts in order of last activity, oldest first, as a doubly linked list
+// threaded through one flat array indexed by the account's position in the
+// bank. Activity is nearly always "now", so touching an account moves it to
+// the tail in O(1), and the dormant accounts are a prefix of the list that
+// is walked in O(result).
+class DormancyIndex {
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Link {
+        uint32_t prev;
+        uint32_t next;
+        int64_t lastActive;   // unix seconds, 0 when never active
+    };
+
+    vector<Link> links;
+    uint32_t head = NONE;
+    uint32_t tail = NONE;
+
+    void unlink(uint32_t position);
+    // Links the position in after its last peer with lastActive no later.
+    void place(uint32_t position);
+
+public:
+    // Replaces the index with lastActive[i] for the account at position i.
+    void rebuild(const vector<int64_t>& lastActive);
+
+    // Records activity at the time for the position, adding it when it is
+    // new. A time older than the one recorded is ignored.
+    void touch(uint32_t position, int64_t lastActive);
+
+    // Calls visit(position, lastActive) for accounts last active before the
+    // limit, oldest first.
+    template <typename Visit>
+    void forEachIdleSince(int64_t limit, Visit visit) const {
+        for (uint32_t at = head; at != NONE && links[at].lastActive < limit; at = links[at].next) {
+            visit(at, links[at].lastActive);
+        }
+    }
+
+    size_t size() const { return links.size(); }
+};
+
+#endif // DORMANCY_INDEX_H
@@ -0,0 +1,41 @@
+#include <algorithm>
+
+#include "./transaction_history.h"
+
+using namespace std;
+
+namespace {
+
+size_t historyCapacity = 32;
+
+} // namespace
+
+TransactionHistory::TransactionHistory(size_t capacity) : capacity(max<size_t>(capacity, 1)) {}
+
+bool TransactionHistory::push(const CustomerTransaction& entry) {
+    if (slots.size() < capacity) {
+        slots.push_back(entry);
+        return false;
+    }
+    slots[next] = entry;
+    next = (next + 1) % capacity;
+    return true;
+}
+
+void TransactionHistory::clear() {
+    slots.clear();
+    next = 0;
+}
+
+const CustomerTransaction& TransactionHistory::newest(size_t i) const {
+    size_t newestSlot = (next + slots.size() - 1) % slots.size();
+    return slots[(newestSlot + slots.size() - i) % slots.size()];
+}
+
+void TransactionHistory::setDefaultCapacity(size_t capacity) {
+    historyCapacity = max<size_t>(capacity, 1);
+}
+
+size_t TransactionHistory::defaultCapacity() {
+    return historyCapacity;
+}
@@ -0,0 +1,44 @@
+#ifndef TRANSACTION_HISTORY_H
+#define TRANSACTION_HISTORY_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+using namespace std;
+
+struct CustomerTransaction {
+    double amount;
+    string type;
+    chrono::system_clock::time_point timestamp; 
+    string description;
+};
+
+// The newest entries of one account in a ring of at most capacity slots;
+// pushing onto a full ring overwrites the oldest. Slots are allocated as
+// entries arrive, so quiet accounts stay small.
+class TransactionHistory {
+private:
+    vector<CustomerTransaction> slots;
+    size_t capacity;
+    size_t next = 0;        // slot the next entry goes to once full
+
+public:
+    explicit TransactionHistory(size_t capacity);
+
+    // Returns true when an older entry was overwritten.
+    bool push(const CustomerTransaction& entry);
+    void clear();
+
+    size_t size() const { return slots.size(); }
+    bool full() const { return slots.size() == capacity; }
+    // newest(0) is the latest entry.
+    const CustomerTransaction& newest(size_t i) const;
+
+    // Capacity of histories created from now on; at least 1.
+    static void setDefaultCapacity(size_t capacity);
+    static size_t defaultCapacity();
+};
+
+#endif // TRANSACTION_HISTORY_H
@@ -6,10 +6,13 @@
 #include <iomanip>
 #include <chrono>
 #include <limits>
+#include <sstream>
 
 #include "../Item/order.h"
 #include "../User/seller.h"
 #include "../Item/analytics.h" 
+#include "../Item/order_index.h"
+#include "../Item/parallel_reduce.h"
 
 using namespace std;
 
@@ -17,26 +20,16 @@ extern vector<Order> orders;
 
 string formatTimePoint(chrono::system_clock::time_point tp);
 
-pair<chrono::system_clock::time_point, chrono::system_clock::time_point> getMinMaxTime(const vector<Order>& orders) {
-    if (orders.empty()) {
+// Read from the ends of the day partitions, without touching the orders.
+pair<chrono::system_clock::time_point, chrono::system_clock::time_point> getMinMaxTime() {
+    chrono::system_clock::time_point minTime, maxTime;
+    if (!orderIndex.timeRange(minTime, maxTime)) {
         return {chrono::system_clock::now(), chrono::system_clock::now()};
     }
-
-    auto minTime = orders[0].getCreationTime();
-    auto maxTime = orders[0].getCreationTime();
-
-    for (const auto& order : orders) {
-        if (order.getCreationTime() < minTime) {
-            minTime = order.getCreationTime();
-        }
-        if (order.getCreationTime() > maxTime) {
-            maxTime = order.getCreationTime();
-        }
-    }
     return {minTime, maxTime};
 }
 
-void showRecentTransactions(const vector<Order>& orders, int nDays) {
+void showRecentTransactions(int nDays) {
     if (nDays <= 0) {
         cout << "The number of days must be greater than zero.\n\n";
         return;
@@ -49,18 +42,28 @@ void showRecentTransactions(const vector<Order>& orders, int nDays) {
 
     cout << "\n-- TRANSACTIONS IN " << nDays << " LAST DAY --\n";
 
-    bool found = false;
-    
-    for (const auto& order : orders) {
-        if (order.getCreationTime() >= nDaysAgo) {
-            found = true;
-            cout << "ID: " << order.getOrderId() 
-                 << " | Buyer: " << order.getBuyerName() 
-                 << " | Store: " << order.getSellerStoreName()
-                 << " | Total: Rp" << fixed << setprecision(2) << order.getTotalAmount()
-                 << " | Status: " << order.getStatus()
-                 << "\n";
-        }
+    // Lines are formatted per shard and printed in order.
+    vector<uint32_t> positions = orderIndex.ordersSince(nDaysAgo);
+    string lines = mapReduce<string>(positions.size(),
+        [&positions](string& text, size_t begin, size_t end) {
+            ostringstream out;
+            out << fixed << setprecision(2);
+            for (size_t i = begin; i < end; ++i) {
+                const Order& order = orders[positions[i]];
+                out << "ID: " << order.getOrderId() 
+                    << " | Buyer: " << order.getBuyerName() 
+                    << " | Store: " << order.getSellerStoreName()
+                    << " | Total: Rp" << order.getTotalAmount()
+                    << " | Status: " << order.getStatusName()
+                    << "\n";
+            }
+            text = out.str();
+        },
+        [](string& text, const string& more) { text += more; });
+
+    bool found = !positions.empty();
+    if (found) {
+        cout << lines;
     }
 
     if (!found) {
@@ -69,7 +72,9 @@ void showRecentTransactions(const vector<Order>& orders, int nDays) {
     cout << "\n\n";
 }
 
-void viewMostActiveBuyersPerDay(const vector<Order>& orders, int nTop, int days) {
+// Counts come from the per-day counters of the order index, so only the
+// partitions inside the window are read.
+void viewMostActiveBuyersPerDay(int nTop, int days) {
     if (nTop <= 0) {
         cout << "The number of best buyers must be greater than zero.\n\n";
         return;
@@ -80,27 +85,17 @@ void viewMostActiveBuyersPerDay(const vector<Order>& orders, int nTop, int days)
         return;
     }
 
-    map<string, int> buyerTxCount;
-    for (const auto& order : orders) {
-        buyerTxCount[order.getBuyerName()]++;
-    }
-    
     double totalDays = static_cast<double>(days);
     
     if (totalDays < 1.0) {
         totalDays = 1.0; 
     }
-    
-    vector<pair<double, string>> buyerRatios;
-    for (const auto& pair : buyerTxCount) {
-        double ratio = static_cast<double>(pair.second) / totalDays;
-        buyerRatios.push_back({ratio, pair.first});
-    }
 
-    sort(buyerRatios.rbegin(), buyerRatios.rend());
+    auto since = chrono::system_clock::now() - chrono::hours(24 * static_cast<int>(totalDays));
+    vector<ActivityCount> buyers = orderIndex.mostActiveBuyersSince(since, static_cast<size_t>(nTop));
 
     cout << "\n-- TOP " << nTop << " MOST ACTIVE BUYERS --\n";
-    cout << "Analysis Period: " << totalDays << " days.\n\n";
+    cout << "Analysis Period: " << fixed << setprecision(2) << totalDays << " days.\n\n";
     cout << left << setw(5) << "Rank"
             << setw(30) << "Buyer Name"
             << setw(15) << "Total Tx"
@@ -108,27 +103,23 @@ void viewMostActiveBuyersPerDay(const vector<Order>& orders, int nTop, int days)
     cout << string(65, '-') << "\n";
 
     int count = 0;
-    for (const auto& pair : buyerRatios) {
-        if (count >= nTop) break;
-
-        double ratio = pair.first;
-        string buyerName = pair.second;
-        int totalTx = buyerTxCount.at(buyerName);
+    for (const auto& buyer : buyers) {
+        double ratio = static_cast<double>(buyer.orders) / totalDays;
 
         cout << left << setw(5) << (count + 1) << ". "
-             << setw(30) << buyerName
-             << setw(15) << totalTx
+             << setw(30) << symbols.name(buyer.name)
+             << setw(15) << buyer.orders
              << ratio << "\n";
         count++;
     }
     
-    if (buyerRatios.empty()) {
+    if (buyers.empty()) {
         cout << "No buyers found.\n";
     }
     cout << "\n\n";
 }
 
-void viewMostActiveSellersPerDay(const vector<Order>& orders, int nTop, int days) {
+void viewMostActiveSellersPerDay(int nTop, int days) {
     if (nTop <= 0) {
         cout << "The number of top sellers must be greater than zero.\n\n";
         return;
@@ -139,24 +130,14 @@ void viewMostActiveSellersPerDay(const vector<Order>& orders, int nTop, int days
         return;
     }
 
-    map<string, int> sellerTxCount;
-    for (const auto& order : orders) {
-        sellerTxCount[order.getSellerStoreName()]++;
-    }
-    
     double totalDays = static_cast<double>(days);
     
     if (totalDays < 1.0) {
         totalDays = 1.0; 
     }
-    
-    vector<pair<double, string>> sellerRatios;
-    for (const auto& pair : sellerTxCount) {
-        double ratio = static_cast<double>(pair.second) / totalDays;
-        sellerRatios.push_back({ratio, pair.first});
-    }
 
-    sort(sellerRatios.rbegin(), sellerRatios.rend());
+    auto since = chrono::system_clock::now() - chrono::hours(24 * static_cast<int>(totalDays));
+    vector<ActivityCount> sellers = orderIndex.mostActiveStoresSince(since, static_cast<size_t>(nTop));
 
     cout << "\n-- TOP " << nTop << " MOST ACTIVE SELLERS --\n";
     cout << "Analysis Period: " << fixed << setprecision(2) << totalDays << " days.\n\n";
@@ -167,22 +148,18 @@ void viewMostActiveSellersPerDay(const vector<Order>& orders, int nTop, int days
     cout << string(65, '-') << "\n";
 
     int count = 0;
-    for (const auto& pair : sellerRatios) {
-        if (count >= nTop) break;
-
-        double ratio = pair.first;
-        string storeName = pair.second;
-        int totalTx = sellerTxCount.at(storeName);
+    for (const auto& seller : sellers) {
+        double ratio = static_cast<double>(seller.orders) / totalDays;
 
         cout << left << setw(5) << (count + 1) << ". "
-             << setw(30) << storeName
-             << setw(15) << totalTx
+             << setw(30) << symbols.name(seller.name)
+             << setw(15) << seller.orders
              << fixed << setprecision(4) << ratio << "\n";
         count++;
     }
     
-    if (sellerRatios.empty()) {
+    if (sellers.empty()) {
         cout << "No sellers were found.\n";
     }
     cout << "\n\n";
-}
\ No newline at end of file
+}
@@ -7,8 +7,10 @@
 
 class Order; 
 
-void showRecentTransactions(const std::vector<Order>& orders, int nDays);
-void viewMostActiveBuyersPerDay(const std::vector<Order>& orders, int nTop, int nDays);
-void viewMostActiveSellersPerDay(const std::vector<Order>& orders, int nTop, int nDays);
+// Orders of the global order list created in the last nDays days.
+void showRecentTransactions(int nDays);
+// Buyers and stores with the most orders in the last nDays days.
+void viewMostActiveBuyersPerDay(int nTop, int nDays);
+void viewMostActiveSellersPerDay(int nTop, int nDays);
 
 #endif // ANALYTICS_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+
+#include "heavy_hitters.h"
+
+using namespace std;
+
+SpaceSaving::SpaceSaving(size_t capacity) : capacity(max<size_t>(capacity, 1)) {
+    counters.reserve(this->capacity);
+    heap.reserve(this->capacity);
+    heapPos.reserve(this->capacity);
+}
+
+void SpaceSaving::swapHeap(size_t a, size_t b) {
+    swap(heap[a], heap[b]);
+    heapPos[heap[a]] = static_cast<uint32_t>(a);
+    heapPos[heap[b]] = static_cast<uint32_t>(b);
+}
+
+void SpaceSaving::siftUp(size_t at) {
+    while (at > 0) {
+        size_t parent = (at - 1) / 2;
+        if (counters[heap[parent]].count <= counters[heap[at]].count) return;
+        swapHeap(at, parent);
+        at = parent;
+    }
+}
+
+void SpaceSaving::siftDown(size_t at) {
+    while (true) {
+        size_t smallest = at;
+        for (size_t child = 2 * at + 1; child <= 2 * at + 2 && child < heap.size(); ++child) {
+            if (counters[heap[child]].count < counters[heap[smallest]].count) smallest = child;
+        }
+        if (smallest == at) return;
+        swapHeap(at, smallest);
+        at = smallest;
+    }
+}
+
+void SpaceSaving::add(uint32_t key, uint64_t weight, uint32_t tag) {
+    total += weight;
+
+    auto found = slotOf.find(key);
+    if (found != slotOf.end()) {
+        HeavyHitter& counter = counters[found->second];
+        counter.count += weight;
+        counter.tag = tag;
+        siftDown(heapPos[found->second]);
+        return;
+    }
+
+    if (counters.size() < capacity) {
+        uint32_t slot = static_cast<uint32_t>(counters.size());
+        counters.push_back({key, tag, weight, 0});
+        heap.push_back(slot);
+        heapPos.push_back(slot);
+        slotOf.emplace(key, slot);
+        siftUp(slot);
+        return;
+    }
+
+    // Evict the smallest counter; the newcomer may have been counted there.
+    uint32_t slot = heap[0];
+    HeavyHitter& counter = counters[slot];
+    slotOf.erase(counter.key);
+    counter = {key, tag, counter.count + weight, counter.count};
+    slotOf.emplace(key, slot);
+    siftDown(0);
+}
+
+vector<HeavyHitter> SpaceSaving::top(size_t k) const {
+    vector<HeavyHitter> ranked(counters);
+    k = min(k, ranked.size());
+    partial_sort(ranked.begin(), ranked.begin() + static_cast<ptrdiff_t>(k), ranked.end(),
+                 [](const HeavyHitter& a, const HeavyHitter& b) {
+                     if (a.count != b.count) return a.count > b.count;
+                     return a.key < b.key;
+                 });
+    ranked.resize(k);
+    return ranked;
+}
+
+uint64_t SpaceSaving::maxError() const {
+    return counters.size() < capacity ? 0 : counters[heap[0]].count;
+}
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+    : width(max<size_t>(width, 1)), depth(max<size_t>(depth, 1)), cells(this->width * this->depth, 0) {}
+
+// A 64-bit finalizer over the key and row gives each row its own hash.
+size_t CountMinSketch::cell(size_t row, uint32_t key) const {
+    uint64_t x = key + (row + 1) * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return row * width + static_cast<size_t>(x % width);
+}
+
+void CountMinSketch::add(uint32_t key, uint64_t weight) {
+    total += weight;
+    for (size_t row = 0; row < depth; ++row) {
+        cells[cell(row, key)] += weight;
+    }
+}
+
+uint64_t CountMinSketch::estimate(uint32_t key) const {
+    uint64_t best = UINT64_MAX;
+    for (size_t row = 0; row < depth; ++row) {
+        best = min(best, cells[cell(row, key)]);
+    }
+    return best;
+}
+
+uint64_t CountMinSketch::errorBound() const {
+    return static_cast<uint64_t>(ceil(exp(1.0) * static_cast<double>(total) / static_cast<double>(width)));
+}
+
+double CountMinSketch::confidence() const {
+    return 1.0 - exp(-static_cast<double>(depth));
+}
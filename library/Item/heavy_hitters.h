@@ -0,0 +1,75 @@
+#ifndef HEAVY_HITTERS_H
+#define HEAVY_HITTERS_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// One monitored key of a Space-Saving summary. The true weight of the key
+// lies between count - error and count. Tag is carried along with the key,
+// e.g. the name symbol of an item counted by id.
+struct HeavyHitter {
+    uint32_t key;
+    uint32_t tag;
+    uint64_t count;
+    uint64_t error;
+};
+
+// Space-Saving summary (Metwally et al.): keeps at most `capacity` counters.
+// A key that is not monitored takes over the smallest counter and inherits
+// its count as error, so every key heavier than total / capacity is kept
+// and no count is more than that over the truth. Counters sit in an
+// indexed min-heap, making each update O(log capacity).
+class SpaceSaving {
+private:
+    size_t capacity;
+    uint64_t total = 0;
+    vector<HeavyHitter> counters;
+    vector<uint32_t> heap;      // counter slots, smallest count first
+    vector<uint32_t> heapPos;   // position of each slot in heap
+    unordered_map<uint32_t, uint32_t> slotOf;
+
+    void swapHeap(size_t a, size_t b);
+    void siftUp(size_t at);
+    void siftDown(size_t at);
+
+public:
+    explicit SpaceSaving(size_t capacity);
+
+    void add(uint32_t key, uint64_t weight, uint32_t tag = 0);
+
+    // The k largest counters, largest first; equal counts by key.
+    vector<HeavyHitter> top(size_t k) const;
+
+    uint64_t totalWeight() const { return total; }
+    // Upper bound on the overestimate of any count; 0 while exact.
+    uint64_t maxError() const;
+};
+
+// Count-Min sketch (Cormode and Muthukrishnan): depth rows of width
+// counters. An estimate never undercounts, and with probability at least
+// 1 - e^-depth it is at most errorBound() over the true weight.
+class CountMinSketch {
+private:
+    size_t width;
+    size_t depth;
+    uint64_t total = 0;
+    vector<uint64_t> cells;
+
+    size_t cell(size_t row, uint32_t key) const;
+
+public:
+    CountMinSketch(size_t width, size_t depth);
+
+    void add(uint32_t key, uint64_t weight);
+    uint64_t estimate(uint32_t key) const;
+
+    // e / width of the total weight, rounded up.
+    uint64_t errorBound() const;
+    double confidence() const;
+};
+
+#endif // HEAVY_HITTERS_H
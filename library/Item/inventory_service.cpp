@@ -0,0 +1,112 @@
+#include <algorithm>
+
+#include "inventory_service.h"
+#include "../Serialization/snapshot_files.h"
+
+using namespace std;
+
+InventoryService inventoryService;
+
+// An id added twice resolves to its first item, as the linear scans did.
+void InventoryService::reindex(StoreStock& stock) {
+    stock.slots.clear();
+    for (size_t i = 0; i < stock.items.size(); ++i) {
+        stock.slots.try_emplace(stock.items[i].getId(), i);
+    }
+}
+
+void InventoryService::markDirty(const string& storeName, StoreStock& stock) {
+    if (stock.dirty) return;
+    stock.dirty = true;
+    dirtyStores.mark(storeName);
+}
+
+void InventoryService::addItem(const string& storeName, const Item& item) {
+    StoreStock& stock = stores[storeName];
+    stock.items.push_back(item);
+    stock.slots.try_emplace(item.getId(), stock.items.size() - 1);
+    markDirty(storeName, stock);
+}
+
+// Removal shifts the items after it, so the store is reindexed; it is rare
+// next to the stock changes that stay O(1).
+bool InventoryService::removeItem(const string& storeName, int itemId) {
+    auto store = stores.find(storeName);
+    if (store == stores.end() || store->second.slots.count(itemId) == 0) return false;
+
+    StoreStock& stock = store->second;
+    stock.items.erase(remove_if(stock.items.begin(), stock.items.end(),
+                                [itemId](const Item& item) { return item.getId() == itemId; }),
+                      stock.items.end());
+    markDirty(storeName, stock);
+    reindex(stock);
+    return true;
+}
+
+bool InventoryService::adjustQuantity(const string& storeName, int itemId, int delta) {
+    auto store = stores.find(storeName);
+    if (store == stores.end()) return false;
+
+    auto slot = store->second.slots.find(itemId);
+    if (slot == store->second.slots.end()) return false;
+
+    Item& item = store->second.items[slot->second];
+    item.setQuantity(item.getQuantity() + delta);
+    markDirty(storeName, store->second);
+    return true;
+}
+
+bool InventoryService::setQuantity(const string& storeName, int itemId, int quantity) {
+    auto store = stores.find(storeName);
+    if (store == stores.end()) return false;
+
+    auto slot = store->second.slots.find(itemId);
+    if (slot == store->second.slots.end()) return false;
+
+    store->second.items[slot->second].setQuantity(quantity);
+    markDirty(storeName, store->second);
+    return true;
+}
+
+const Item* InventoryService::findItem(const string& storeName, int itemId) const {
+    auto store = stores.find(storeName);
+    if (store == stores.end()) return nullptr;
+
+    auto slot = store->second.slots.find(itemId);
+    if (slot == store->second.slots.end()) return nullptr;
+    return &store->second.items[slot->second];
+}
+
+const vector<Item>& InventoryService::items(const string& storeName) const {
+    static const vector<Item> none;
+    auto store = stores.find(storeName);
+    return store == stores.end() ? none : store->second.items;
+}
+
+vector<string> InventoryService::storesInStock() const {
+    vector<string> names;
+    for (const auto& store : stores) {
+        for (const auto& item : store.second.items) {
+            if (item.getQuantity() > 0) {
+                names.push_back(store.first);
+                break;
+            }
+        }
+    }
+    sort(names.begin(), names.end());
+    return names;
+}
+
+bool InventoryService::isDirty(const string& storeName) const {
+    auto store = stores.find(storeName);
+    return store != stores.end() && store->second.dirty;
+}
+
+void InventoryService::clearDirty(const string& storeName) {
+    auto store = stores.find(storeName);
+    if (store == stores.end()) return;
+    store->second.dirty = false;
+    for (auto& item : store->second.items) {
+        item.clearDirty();
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef INVENTORY_SERVICE_H
+#define INVENTORY_SERVICE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "item.h"
+
+using namespace std;
+
+// Stock of one store. Items keep the order they were added in, which is the
+// order they are listed and saved in; slots maps an item id to its position.
+struct StoreStock {
+    vector<Item> items;
+    unordered_map<int, size_t> slots;
+    bool dirty = false;
+};
+
+// The one in-memory copy of every store's stock, shared by the sellers that
+// own it and the buyers browsing it. Lookups and stock changes are O(1);
+// the inventory files only catch up through the write-ahead log and the
+// snapshots at checkpoints.
+class InventoryService {
+private:
+    unordered_map<string, StoreStock> stores;
+
+    void reindex(StoreStock& stock);
+    void markDirty(const string& storeName, StoreStock& stock);
+
+public:
+    void addItem(const string& storeName, const Item& item);
+    bool removeItem(const string& storeName, int itemId);
+    bool adjustQuantity(const string& storeName, int itemId, int delta);
+    bool setQuantity(const string& storeName, int itemId, int quantity);
+
+    const Item* findItem(const string& storeName, int itemId) const;
+    const vector<Item>& items(const string& storeName) const;
+
+    // Stores with at least one item in stock, by name.
+    vector<string> storesInStock() const;
+
+    // True when an item was added, changed or removed since the last save.
+    // The store is listed in dirtyStores when the flag is set.
+    bool isDirty(const string& storeName) const;
+    void clearDirty(const string& storeName);
+};
+
+extern InventoryService inventoryService;
+
+#endif // INVENTORY_SERVICE_H
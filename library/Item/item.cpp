@@ -3,18 +3,33 @@
 #include <string>
 
 #include "./item.h"
+#include "../Serialization/csv_codec.h"
 
 using namespace std;
 
-shared_ptr<Item> Item::fromCSV(const vector<string>& tokens) {
+shared_ptr<Item> Item::fromCSV(span<const string_view> tokens) {
     if (tokens.size() < 4) return nullptr;
-    try {
-        int id = stoi(tokens[0]);
-        string name = tokens[1];
-        int quantity = stoi(tokens[2]);
-        double price = stod(tokens[3]);
-        return make_shared<Item>(id, name, quantity, price);
-    } catch (...) {
+
+    int id, quantity;
+    double price;
+    if (!parseNumber(tokens[0], id) || !parseNumber(tokens[2], quantity) || !parseNumber(tokens[3], price)) {
         return nullptr;
     }
+    return make_shared<Item>(id, tokens[1], quantity, price);
+}
+
+void Item::appendCSV(string& out) const {
+    appendNumber(out, id);
+    out += ',';
+    out += symbols.name(name);
+    out += ',';
+    appendNumber(out, quantity);
+    out += ',';
+    appendFixed(out, price, 2);
+}
+
+string Item::toCSV() const {
+    string out;
+    appendCSV(out);
+    return out;
 }
\ No newline at end of file
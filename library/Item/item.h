@@ -6,56 +6,71 @@
 #include <iomanip>
 #include <vector>
 #include <memory>
+#include <span>
+#include <string_view>
+
+#include "symbol_table.h"
 
 using namespace std;
 
 class Item {
 private:
     int id;
-    string name;
+    Symbol name;
     int quantity;
     double price;
     bool idDisplay;
-    string sellerStoreName;
+    bool dirty;
 
 public:
-    Item(int id, const std::string& name, int quantity, double price)
-        : id(id), name(name), quantity(quantity), price(price) {
+    Item(int id, string_view name, int quantity, double price)
+        : id(id), name(symbols.intern(name)), quantity(quantity), price(price), dirty(true) {
             idDisplay = false;
         }
 
-    string toCSV() const {
-        stringstream ss;
-        ss << id << "," << name << "," << quantity << "," << fixed << setprecision(2) << price;
-        return ss.str();
-    }
+    // Appends "id,name,quantity,price" to out.
+    void appendCSV(string& out) const;
+    string toCSV() const;
+
+    Item(string_view name, double price, int quantity, [[maybe_unused]] Symbol sellerStoreName)
+        : id(0), name(symbols.intern(name)), quantity(quantity), price(price), dirty(true) {
+             idDisplay = false; 
+        }
 
-    Item(const std::string& name, double price, int quantity, [[maybe_unused]] const std::string& sellerStoreName)
-        : id(0), name(name), quantity(quantity), price(price), sellerStoreName(sellerStoreName) {
+    // For names already interned, possibly in a LocalSymbols.
+    Item(Symbol name, double price, int quantity)
+        : id(0), name(name), quantity(quantity), price(price), dirty(true) {
              idDisplay = false; 
         }
 
-    static shared_ptr<Item> fromCSV(const vector<string>& tokens);
+    static shared_ptr<Item> fromCSV(span<const string_view> tokens);
 
     int getId() const { return id; }
-    const std::string& getName() const { return name; }
+    const std::string& getName() const { return symbols.name(name); }
+    Symbol getNameSymbol() const { return name; }
+    // Swaps a LocalSymbols id for its global one.
+    void remapSymbols(const vector<Symbol>& global) { name = global[name]; }
     int getQuantity() const { return quantity; }
     double getPrice() const { return price; }
     Item *getItem() {
         return this;
     }
 
-    void setId(int newId) { id = newId; }
-    void setName(const std::string& newName) { name = newName; }
-    void setQuantity(int newQuantity) { quantity = newQuantity; }
-    void setPrice(double newPrice) { price = newPrice; }
+    void setId(int newId) { id = newId; dirty = true; }
+    void setName(string_view newName) { name = symbols.intern(newName); dirty = true; }
+    void setQuantity(int newQuantity) { quantity = newQuantity; dirty = true; }
+    void setPrice(double newPrice) { price = newPrice; dirty = true; }
     void setDisplay(bool display) { idDisplay = display; }
 
-    void alterItemById(int itemId, const std::string& newName, int newQuantity, double newPrice) {
+    bool isDirty() const { return dirty; }
+    void clearDirty() { dirty = false; }
+
+    void alterItemById(int itemId, string_view newName, int newQuantity, double newPrice) {
         if (id == itemId) {
-            name = newName;
+            name = symbols.intern(newName);
             quantity = newQuantity;
             price = newPrice;
+            dirty = true;
         }
     }
 
@@ -63,6 +78,7 @@ public:
         if (id == itemId) {
             price = newPrice;
             quantity = newQuantity;
+            dirty = true;
         }
     }
 };
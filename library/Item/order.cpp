@@ -9,88 +9,133 @@
 #include <iomanip>
 
 #include "./order.h"
+#include "../Serialization/civil_time.h"
+#include "../Serialization/csv_codec.h"
 
 using namespace std;
 
+const char* statusName(OrderStatus status) {
+    switch (status) {
+        case STATUS_PENDING: return "Pending";
+        case STATUS_DONE: return "DONE";
+        case STATUS_CANCELED: return "CANCELED";
+        case STATUS_INCOMPLETE: return "INCOMPLETE";
+    }
+    return "Pending";
+}
+
+bool parseOrderStatus(string_view text, OrderStatus& status) {
+    if (text == "DONE") {
+        status = STATUS_DONE;
+    } else if (text == "CANCELED") {
+        status = STATUS_CANCELED;
+    } else if (text == "INCOMPLETE") {
+        status = STATUS_INCOMPLETE;
+    } else if (text == "Pending") {
+        status = STATUS_PENDING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 void Order::setTotalAmount(double totalAmount) {
     this->totalAmount = totalAmount; 
 }
 
 string Order::getFormattedCreationTime() const {
-    time_t tt = chrono::system_clock::to_time_t(creationTime);
-    tm tm_local = *localtime(&tt);
-    stringstream ss;
-    ss << put_time(&tm_local, "%Y-%m-%d %H:%M:%S");
-    
-    return ss.str();
+    char buffer[CIVIL_TIME_LENGTH];
+    if (!formatLocalTime(creationTime, buffer)) return "UnknownTime";
+    return string(buffer, CIVIL_TIME_LENGTH);
+}
+
+string monthKeyName(int32_t monthKey) {
+    char buffer[YEAR_MONTH_LENGTH];
+    if (!formatYearMonth(monthKey, buffer)) return "UnknownTime";
+    return string(buffer, YEAR_MONTH_LENGTH);
 }
 
 string Order::getYearMonthString() const {
-    time_t tt = chrono::system_clock::to_time_t(creationTime);
-    tm tm = *localtime(&tt);
-    stringstream ss;
-    ss << put_time(&tm, "%Y-%m");
-    return ss.str();
+    return monthKeyName(monthKey);
+}
+
+void Order::updateKeys() {
+    int64_t day = localDayNumber(creationTime);
+    dayKey = static_cast<int32_t>(day);
+    monthKey = monthNumber(day);
 }
 
 void Order::setCreationTime(chrono::system_clock::time_point time) {
     creationTime = time;
+    updateKeys();
 }
 
-Order Order::fromCSV(const vector<string>& tokens) {
-    int id = stoi(tokens[0]);
-    string buyer = tokens[1];
-    string seller = tokens[2];
-    double total = stod(tokens[3]);
-    string statusStr = tokens[4];
+optional<Order> Order::fromCSV(span<const string_view> tokens, LocalSymbols* local) {
+    if (tokens.size() < 5) return nullopt;
+
+    int id;
+    double total;
+    OrderStatus status;
+    if (!parseNumber(tokens[0], id) || !parseNumber(tokens[3], total) || !parseOrderStatus(tokens[4], status)) {
+        return nullopt;
+    }
 
     chrono::system_clock::time_point loadedTime;
+    long long timestamp;
+    if (tokens.size() > 5 && parseNumber(tokens[5], timestamp)) {
+        loadedTime = chrono::system_clock::from_time_t(static_cast<time_t>(timestamp));
+    }
+
+    auto intern = [local](string_view name) { return local ? local->intern(name) : symbols.intern(name); };
 
-    if (tokens.size() > 5) {
-        try {
-            long long timestamp = stoll(tokens[5]);
-            loadedTime = chrono::system_clock::from_time_t(timestamp);
-        } catch (const exception& e) {
+    Symbol seller = intern(tokens[2]);
+    vector<Item> items;
+    for (size_t i = 6; i + 2 < tokens.size(); i += 3) {
+        int quantity;
+        double price;
+        if (!parseNumber(tokens[i + 1], quantity) || !parseNumber(tokens[i + 2], price)) {
+            return nullopt;
         }
+        items.emplace_back(intern(tokens[i]), price, quantity);
     }
-    
-    Order loadedOrder(id, buyer, seller);
-    
-    loadedOrder.setTotalAmount(total);
-    loadedOrder.setStatus(statusStr);
-    loadedOrder.setCreationTime(loadedTime);
-
-    for (size_t i = 6; i < tokens.size(); i += 3) {
-    if (i + 2 < tokens.size()) {
-        string itemName = tokens[i];
-        int quantity = stoi(tokens[i+1]);
-        double price = stod(tokens[i+2]);
-        
-        Item item(itemName, price, quantity, loadedOrder.getSellerStoreName());
-        
-        loadedOrder.addItem(item); 
-    }
+
+    // The stored total is authoritative; items are not summed again.
+    return Order(id, intern(tokens[1]), seller, total, status, move(items), loadedTime);
 }
 
-    return loadedOrder;
+void Order::remapSymbols(const vector<Symbol>& global) {
+    buyerName = global[buyerName];
+    sellerStoreName = global[sellerStoreName];
+    for (auto& item : items) item.remapSymbols(global);
 }
 
-string Order::toCSV() const {
-    auto timestamp = chrono::system_clock::to_time_t(creationTime); 
-    
-    stringstream ss;
-    
-    ss << orderId << "," 
-       << buyerName << "," 
-       << sellerStoreName << "," 
-       << totalAmount << "," 
-       << status 
-       << "," << timestamp;
-    
+void Order::appendCSV(string& out) const {
+    appendNumber(out, orderId);
+    out += ',';
+    out += getBuyerName();
+    out += ',';
+    out += getSellerStoreName();
+    out += ',';
+    appendNumber(out, totalAmount);
+    out += ',';
+    out += statusName(status);
+    out += ',';
+    appendNumber(out, static_cast<long long>(chrono::system_clock::to_time_t(creationTime)));
+
     for (const auto& item : items) {
-        ss << ";" << item.getId() << "," << item.getName() << "," 
-           << item.getQuantity() << "," << item.getPrice(); 
+        out += ';';
+        appendNumber(out, item.getId());
+        out += ',';
+        out += item.getName();
+        out += ',';
+        appendNumber(out, item.getQuantity());
+        out += ',';
+        appendNumber(out, item.getPrice());
     }
-    
-    return ss.str();
-}
\ No newline at end of file
+}
+
+string Order::toCSV() const {
+    string out;
+    appendCSV(out);
+    return out;
+}
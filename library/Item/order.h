@@ -4,40 +4,61 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <span>
+#include <optional>
+#include <string_view>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
 
 #include "../Item/item.h" 
+#include "../Item/symbol_table.h"
 
 using namespace std;
 
+enum OrderStatus : uint8_t { STATUS_PENDING, STATUS_DONE, STATUS_CANCELED, STATUS_INCOMPLETE };
+
+// The text written to the order file, e.g. "DONE".
+const char* statusName(OrderStatus status);
+bool parseOrderStatus(string_view text, OrderStatus& status);
+
+// "YYYY-MM" for a month key, as in Order::getMonthKey.
+string monthKeyName(int32_t monthKey);
+
 class Order {
 private:
     int orderId;
-    string buyerName;
-    string sellerStoreName;
+    Symbol buyerName;
+    Symbol sellerStoreName;
+    OrderStatus status;
     double totalAmount;
-    string status;
     vector<Item> items;
     chrono::system_clock::time_point creationTime;   
+    // Local day number and month number of creationTime, kept with it so
+    // reports never convert times per row.
+    int32_t dayKey;
+    int32_t monthKey;
+
+    void updateKeys();
 
 public:
-    Order(int id, const string& buyer, const string& sellerStore) 
-        : orderId(id), buyerName(buyer), sellerStoreName(sellerStore), 
-          totalAmount(0.0), status("Pending"),
-          creationTime(chrono::system_clock::now()) {}
+    Order(int id, string_view buyer, string_view sellerStore) 
+        : orderId(id), buyerName(symbols.intern(buyer)), sellerStoreName(symbols.intern(sellerStore)), 
+          status(STATUS_PENDING), totalAmount(0.0),
+          creationTime(chrono::system_clock::now()) { updateKeys(); }
     
-    Order(int id, const string& buyer, const string& sellerStore, 
-          double total, const string& stat, const vector<Item>& itemList,
+    Order(int id, Symbol buyer, Symbol sellerStore, 
+          double total, OrderStatus stat, vector<Item> itemList,
           chrono::system_clock::time_point time)
         : orderId(id), buyerName(buyer), sellerStoreName(sellerStore), 
-          totalAmount(total), status(stat), items(itemList), creationTime(time) {}
+          status(stat), totalAmount(total), items(move(itemList)), creationTime(time) { updateKeys(); }
     
     chrono::system_clock::time_point getCreationTime() const { return creationTime; }
 
     void setCreationTime(chrono::system_clock::time_point time);
     string getYearMonthString() const;
+    int32_t getDayKey() const { return dayKey; }
+    int32_t getMonthKey() const { return monthKey; }
 
     string getFormattedCreationTime() const;
 
@@ -46,19 +67,27 @@ public:
         totalAmount += item.getQuantity() * item.getPrice();
     }
 
+    // Appends the order row to out; toCSV returns it as a new string.
+    void appendCSV(string& out) const;
     string toCSV() const;
 
     int getOrderId() const { return orderId; }
-    const string& getBuyerName() const { return buyerName; }
-    const string& getSellerStoreName() const { return sellerStoreName; }
+    const string& getBuyerName() const { return symbols.name(buyerName); }
+    const string& getSellerStoreName() const { return symbols.name(sellerStoreName); }
+    Symbol getBuyerSymbol() const { return buyerName; }
+    Symbol getStoreSymbol() const { return sellerStoreName; }
     const vector<Item>& getItems() const { return items; }
     void setTotalAmount(double amount); 
     double getTotalAmount() const { return totalAmount; }
-    const string& getStatus() const { return status; }
+    OrderStatus getStatus() const { return status; }
+    const char* getStatusName() const { return statusName(status); }
     
-    void setStatus(const string& newStatus) { status = newStatus; }
+    void setStatus(OrderStatus newStatus) { status = newStatus; }
 
-    static Order fromCSV(const vector<string>& tokens);
+    // Empty when a required field is missing or not a number. Names go into
+    // local when given, and the order then needs remapSymbols.
+    static optional<Order> fromCSV(span<const string_view> tokens, LocalSymbols* local = nullptr);
+    void remapSymbols(const vector<Symbol>& global);
 };
 
 #endif // ORDER_H
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <queue>
+
+#include "order_index.h"
+#include "parallel_reduce.h"
+
+using namespace std;
+
+namespace {
+
+int64_t dayOf(chrono::system_clock::time_point time) {
+    return chrono::floor<chrono::days>(time).time_since_epoch().count();
+}
+
+// Day counters hold one entry per active buyer or store, so a few days
+// already make a shard worth a thread.
+const size_t DAYS_PER_SHARD = 8;
+
+void dropFrom(vector<uint32_t>& postings, uint32_t position) {
+    auto it = find(postings.rbegin(), postings.rend(), position);
+    if (it != postings.rend()) postings.erase(next(it).base());
+}
+
+} // namespace
+
+OrderIndex::OrderIndex(const vector<Order>& orders) : orders(orders) {}
+
+vector<uint32_t>& OrderIndex::postingsFor(vector<vector<uint32_t>>& postings, Symbol name) {
+    if (name >= postings.size()) postings.resize(name + 1);
+    return postings[name];
+}
+
+// Orders arrive mostly in time order, so the position nearly always goes
+// at the end; equal times keep their list order.
+void OrderIndex::post(vector<uint32_t>& postings, uint32_t position) const {
+    auto time = orders[position].getCreationTime();
+    if (postings.empty() || orders[postings.back()].getCreationTime() <= time) {
+        postings.push_back(position);
+        return;
+    }
+    auto at = upper_bound(postings.begin(), postings.end(), time,
+                          [this](chrono::system_clock::time_point t, uint32_t p) {
+                              return t < orders[p].getCreationTime();
+                          });
+    postings.insert(at, position);
+}
+
+// New days nearly always come last; an older one is inserted in place.
+vector<OrderPartition>::iterator OrderIndex::partitionOf(int64_t day) {
+    if (!days.empty() && days.back().day == day) return days.end() - 1;
+
+    auto at = lower_bound(days.begin(), days.end(), day,
+                          [](const OrderPartition& partition, int64_t d) { return partition.day < d; });
+    if (at == days.end() || at->day != day) {
+        OrderPartition partition;
+        partition.day = day;
+        at = days.insert(at, partition);
+    }
+    return at;
+}
+
+void OrderIndex::postByDay(OrderPartition& partition, uint32_t position) {
+    const Order& order = orders[position];
+    partition.buyerOrders[order.getBuyerSymbol()]++;
+    partition.storeOrders[order.getStoreSymbol()]++;
+
+    auto time = order.getCreationTime();
+    if (partition.positions.empty()) {
+        partition.minTime = partition.maxTime = time;
+    } else {
+        partition.minTime = min(partition.minTime, time);
+        partition.maxTime = max(partition.maxTime, time);
+    }
+    post(partition.positions, position);
+}
+
+void OrderIndex::refresh() {
+    if (keysAt.size() > orders.size()) truncate(orders.size());
+
+    keysAt.reserve(orders.size());
+    for (size_t i = keysAt.size(); i < orders.size(); ++i) {
+        const Order& order = orders[i];
+        Symbol buyer = order.getBuyerSymbol();
+        Symbol store = order.getStoreSymbol();
+        int64_t day = dayOf(order.getCreationTime());
+        post(postingsFor(buyerPostings, buyer), static_cast<uint32_t>(i));
+        post(postingsFor(storePostings, store), static_cast<uint32_t>(i));
+        postByDay(*partitionOf(day), static_cast<uint32_t>(i));
+        keysAt.push_back({buyer, store, day});
+    }
+}
+
+// Dropped positions are the newest ones, so they sit at or near the end
+// of their lists.
+void OrderIndex::truncate(size_t size) {
+    if (size == 0) {
+        buyerPostings.clear();
+        storePostings.clear();
+        days.clear();
+        keysAt.clear();
+        return;
+    }
+
+    vector<int64_t> touched;
+    while (keysAt.size() > size) {
+        uint32_t position = static_cast<uint32_t>(keysAt.size() - 1);
+        const IndexedOrder& keys = keysAt.back();
+        dropFrom(buyerPostings[keys.buyer], position);
+        dropFrom(storePostings[keys.store], position);
+        auto partition = partitionOf(keys.day);
+        dropFrom(partition->positions, position);
+        if (--partition->buyerOrders[keys.buyer] == 0) partition->buyerOrders.erase(keys.buyer);
+        if (--partition->storeOrders[keys.store] == 0) partition->storeOrders.erase(keys.store);
+        if (touched.empty() || touched.back() != keys.day) touched.push_back(keys.day);
+        keysAt.pop_back();
+    }
+
+    // Time bounds are read back once every dropped order is gone from the
+    // partitions, since the list no longer holds those orders.
+    for (int64_t day : touched) {
+        auto partition = partitionOf(day);
+        if (partition->positions.empty()) {
+            days.erase(partition);
+            continue;
+        }
+        partition->minTime = orders[partition->positions.front()].getCreationTime();
+        partition->maxTime = orders[partition->positions.back()].getCreationTime();
+    }
+}
+
+const vector<uint32_t>& OrderIndex::postingsOf(const vector<vector<uint32_t>>& postings, const string& name) {
+    static const vector<uint32_t> none;
+    refresh();
+    Symbol symbol;
+    if (!symbols.find(name, symbol) || symbol >= postings.size()) return none;
+    return postings[symbol];
+}
+
+const vector<uint32_t>& OrderIndex::ordersOfBuyer(const string& buyerName) {
+    return postingsOf(buyerPostings, buyerName);
+}
+
+const vector<uint32_t>& OrderIndex::ordersOfStore(const string& storeName) {
+    return postingsOf(storePostings, storeName);
+}
+
+size_t OrderIndex::firstSince(const vector<uint32_t>& postings, chrono::system_clock::time_point since) const {
+    auto at = lower_bound(postings.begin(), postings.end(), since,
+                          [this](uint32_t p, chrono::system_clock::time_point t) {
+                              return orders[p].getCreationTime() < t;
+                          });
+    return static_cast<size_t>(at - postings.begin());
+}
+
+vector<uint32_t> OrderIndex::ordersSince(chrono::system_clock::time_point since) {
+    refresh();
+    vector<uint32_t> positions;
+
+    auto first = partition_point(days.begin(), days.end(),
+                                 [since](const OrderPartition& partition) { return partition.maxTime < since; });
+    for (auto partition = first; partition != days.end(); ++partition) {
+        size_t from = (partition == first) ? firstSince(partition->positions, since) : 0;
+        positions.insert(positions.end(), partition->positions.begin() + static_cast<ptrdiff_t>(from),
+                         partition->positions.end());
+    }
+    return positions;
+}
+
+const vector<OrderPartition>& OrderIndex::partitions() {
+    refresh();
+    return days;
+}
+
+vector<ActivityCount> OrderIndex::mostActiveSince(chrono::system_clock::time_point since, size_t n, bool byStore) {
+    refresh();
+    typedef unordered_map<Symbol, uint32_t> Totals;
+
+    // Whole days are summed from their counters, shard by shard.
+    auto first = partition_point(days.begin(), days.end(),
+                                 [since](const OrderPartition& partition) { return partition.maxTime < since; });
+    size_t firstWhole = static_cast<size_t>(first - days.begin());
+    Totals totals;
+    if (first != days.end() && first->minTime < since) {
+        // Only the first partition can start before the window.
+        for (size_t i = firstSince(first->positions, since); i < first->positions.size(); ++i) {
+            const Order& order = orders[first->positions[i]];
+            totals[byStore ? order.getStoreSymbol() : order.getBuyerSymbol()]++;
+        }
+        firstWhole++;
+    }
+
+    auto addTotals = [](Totals& into, const Totals& from) {
+        for (const auto& count : from) into[count.first] += count.second;
+    };
+    addTotals(totals, mapReduce<Totals>(days.size() - firstWhole,
+        [&](Totals& part, size_t begin, size_t end) {
+            for (size_t i = firstWhole + begin; i < firstWhole + end; ++i) {
+                addTotals(part, byStore ? days[i].storeOrders : days[i].buyerOrders);
+            }
+        },
+        addTotals, DAYS_PER_SHARD));
+
+    // Min-heap of the best n so far; its top is the weakest of them.
+    auto ranksBelow = [](const ActivityCount& a, const ActivityCount& b) {
+        if (a.orders != b.orders) return a.orders < b.orders;
+        return symbols.name(a.name) < symbols.name(b.name);
+    };
+    auto weakestOnTop = [&ranksBelow](const ActivityCount& a, const ActivityCount& b) { return ranksBelow(b, a); };
+    priority_queue<ActivityCount, vector<ActivityCount>, decltype(weakestOnTop)> best(weakestOnTop);
+    for (const auto& total : totals) {
+        ActivityCount candidate{total.first, total.second};
+        if (best.size() < n) {
+            best.push(candidate);
+        } else if (n > 0 && ranksBelow(best.top(), candidate)) {
+            best.pop();
+            best.push(candidate);
+        }
+    }
+
+    vector<ActivityCount> ranked;
+    ranked.reserve(best.size());
+    for (; !best.empty(); best.pop()) ranked.push_back(best.top());
+    reverse(ranked.begin(), ranked.end());
+    return ranked;
+}
+
+vector<ActivityCount> OrderIndex::mostActiveBuyersSince(chrono::system_clock::time_point since, size_t n) {
+    return mostActiveSince(since, n, false);
+}
+
+vector<ActivityCount> OrderIndex::mostActiveStoresSince(chrono::system_clock::time_point since, size_t n) {
+    return mostActiveSince(since, n, true);
+}
+
+bool OrderIndex::timeRange(chrono::system_clock::time_point& minTime, chrono::system_clock::time_point& maxTime) {
+    refresh();
+    if (days.empty()) return false;
+    minTime = days.front().minTime;
+    maxTime = days.back().maxTime;
+    return true;
+}
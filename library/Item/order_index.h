@@ -0,0 +1,90 @@
+#ifndef ORDER_INDEX_H
+#define ORDER_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <unordered_map>
+
+#include "order.h"
+
+using namespace std;
+
+// Orders created on one UTC day, in creation-time order.
+struct OrderPartition {
+    int64_t day = 0;                       // days since 1970-01-01
+    chrono::system_clock::time_point minTime;
+    chrono::system_clock::time_point maxTime;
+    vector<uint32_t> positions;
+    // Orders per buyer and per store on this day.
+    unordered_map<Symbol, uint32_t> buyerOrders;
+    unordered_map<Symbol, uint32_t> storeOrders;
+};
+
+struct ActivityCount {
+    Symbol name;
+    uint32_t orders;
+};
+
+// Posting lists over the global order list: the positions of each buyer's
+// and each store's orders, sorted by creation time and looked up by the
+// name's symbol. Orders appended to the
+// list are picked up by the next query. Code that shrinks the list must
+// call truncate() so positions past the new end are forgotten.
+//
+// The same positions are also split into per-day partitions, kept in day
+// order, so a time window only reads the partitions it overlaps.
+class OrderIndex {
+private:
+    const vector<Order>& orders;
+    vector<vector<uint32_t>> buyerPostings;
+    vector<vector<uint32_t>> storePostings;
+    vector<OrderPartition> days;
+    // Buyer, store and day of every indexed position.
+    struct IndexedOrder {
+        Symbol buyer;
+        Symbol store;
+        int64_t day;
+    };
+    vector<IndexedOrder> keysAt;
+
+    static vector<uint32_t>& postingsFor(vector<vector<uint32_t>>& postings, Symbol name);
+    void post(vector<uint32_t>& postings, uint32_t position) const;
+    vector<OrderPartition>::iterator partitionOf(int64_t day);
+    void postByDay(OrderPartition& partition, uint32_t position);
+    vector<ActivityCount> mostActiveSince(chrono::system_clock::time_point since, size_t n, bool byStore);
+    const vector<uint32_t>& postingsOf(const vector<vector<uint32_t>>& postings, const string& name);
+
+public:
+    explicit OrderIndex(const vector<Order>& orders);
+
+    // Indexes the orders appended since the last call.
+    void refresh();
+    void truncate(size_t size);
+
+    const vector<uint32_t>& ordersOfBuyer(const string& buyerName);
+    const vector<uint32_t>& ordersOfStore(const string& storeName);
+
+    // First entry of the postings created at or after the given time.
+    size_t firstSince(const vector<uint32_t>& postings, chrono::system_clock::time_point since) const;
+
+    // Positions of the orders created at or after the given time, oldest
+    // first. Partitions that end before it are skipped by binary search.
+    vector<uint32_t> ordersSince(chrono::system_clock::time_point since);
+
+    const vector<OrderPartition>& partitions();
+
+    // The n buyers or stores with the most orders created at or after the
+    // given time, most first; ties go to the name that sorts last. Built
+    // from the day counters of the partitions in the window.
+    vector<ActivityCount> mostActiveBuyersSince(chrono::system_clock::time_point since, size_t n);
+    vector<ActivityCount> mostActiveStoresSince(chrono::system_clock::time_point since, size_t n);
+
+    // Creation time of the oldest and newest order; false with no orders.
+    bool timeRange(chrono::system_clock::time_point& minTime, chrono::system_clock::time_point& maxTime);
+};
+
+extern OrderIndex orderIndex;
+
+#endif // ORDER_INDEX_H
@@ -0,0 +1,66 @@
+#include <memory>
+
+#include "parallel_reduce.h"
+
+using namespace std;
+
+namespace {
+
+size_t configuredThreads = 0;
+unique_ptr<ThreadPool> pool;
+once_flag poolStarted;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads) {
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> guard(lock);
+        tasks.push_back(move(task));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+size_t analyticsThreads() {
+    if (configuredThreads == 0) configuredThreads = max(1u, thread::hardware_concurrency());
+    return configuredThreads;
+}
+
+void setAnalyticsThreads(size_t threads) {
+    configuredThreads = threads;
+}
+
+ThreadPool& analyticsPool() {
+    call_once(poolStarted, [] { pool = make_unique<ThreadPool>(analyticsThreads()); });
+    return *pool;
+}
@@ -0,0 +1,89 @@
+#ifndef PARALLEL_REDUCE_H
+#define PARALLEL_REDUCE_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <latch>
+#include <algorithm>
+#include <exception>
+#include <cstddef>
+
+using namespace std;
+
+// Fixed set of worker threads running submitted tasks in FIFO order.
+class ThreadPool {
+private:
+    vector<thread> workers;
+    deque<function<void()>> tasks;
+    mutex lock;
+    condition_variable wake;
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+};
+
+// Smallest shard worth a thread, in orders.
+const size_t PARALLEL_MIN_ITEMS = 32768;
+
+// Workers of the analytics pool: one per hardware thread unless set
+// before the first job. The pool is started by the first parallel job.
+size_t analyticsThreads();
+void setAnalyticsThreads(size_t threads);
+ThreadPool& analyticsPool();
+
+// Splits [0, count) into contiguous shards of at least minShard items, at
+// most one per analytics worker, and runs mapShard(partial, begin, end) on
+// each into its own Partial. The partials are then merged into the first
+// in shard order, so any merge that is exact for a split of the input
+// (integer counts, concatenation, last-write-wins maps) gives the same
+// result as one serial pass. Jobs must not start other jobs. If a shard
+// throws, the other shards still finish and the first exception, in shard
+// order, is rethrown to the caller.
+template <typename Partial, typename MapShard, typename Merge>
+Partial mapReduce(size_t count, MapShard mapShard, Merge merge, size_t minShard = PARALLEL_MIN_ITEMS) {
+    size_t shards = min(analyticsThreads(), count / max<size_t>(minShard, 1));
+    if (shards <= 1) {
+        Partial result{};
+        mapShard(result, size_t(0), count);
+        return result;
+    }
+
+    vector<Partial> partials(shards);
+    vector<exception_ptr> failures(shards);
+    latch done(static_cast<ptrdiff_t>(shards));
+    for (size_t i = 0; i < shards; ++i) {
+        analyticsPool().submit([&, i] {
+            try {
+                mapShard(partials[i], count * i / shards, count * (i + 1) / shards);
+            } catch (...) {
+                failures[i] = current_exception();
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+
+    for (const auto& failure : failures) {
+        if (failure) rethrow_exception(failure);
+    }
+
+    for (size_t i = 1; i < shards; ++i) {
+        merge(partials[0], partials[i]);
+    }
+    return move(partials[0]);
+}
+
+#endif // PARALLEL_REDUCE_H
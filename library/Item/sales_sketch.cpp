@@ -0,0 +1,110 @@
+#include <algorithm>
+
+#include "sales_sketch.h"
+
+using namespace std;
+
+SalesSummary::SalesSummary(const SketchSettings& settings)
+    : candidates(settings.counters), counts(settings.width, settings.depth) {}
+
+void SalesSummary::add(uint32_t key, uint64_t weight, uint32_t tag) {
+    candidates.add(key, weight, tag);
+    counts.add(key, weight);
+}
+
+vector<TopEstimate> SalesSummary::top(size_t k) const {
+    vector<TopEstimate> ranked;
+    for (const auto& counter : candidates.top(SIZE_MAX)) {
+        uint64_t upper = min(counter.count, counts.estimate(counter.key));
+        ranked.push_back({counter.key, counter.tag, upper, counter.count - counter.error});
+    }
+    k = min(k, ranked.size());
+    partial_sort(ranked.begin(), ranked.begin() + static_cast<ptrdiff_t>(k), ranked.end(),
+                 [](const TopEstimate& a, const TopEstimate& b) {
+                     if (a.upper != b.upper) return a.upper > b.upper;
+                     return a.key < b.key;
+                 });
+    ranked.resize(k);
+    return ranked;
+}
+
+SalesSketches::SalesSketches(const vector<Order>& orders) : orders(orders) {}
+
+void SalesSketches::configure(const SketchSettings& settings) {
+    this->settings = settings;
+    truncate(0);
+}
+
+bool SalesSketches::wantsSketches(const StoreSales& sales) const {
+    if (settings.mode == TOPK_EXACT) return false;
+    return settings.mode == TOPK_APPROX || sales.doneOrders > settings.exactLimit;
+}
+
+void SalesSketches::addToSketches(StoreSales& sales, const Order& order) {
+    int32_t month = order.getMonthKey();
+    auto at = lower_bound(sales.months.begin(), sales.months.end(), month,
+                          [](const MonthSales& m, int32_t value) { return m.month < value; });
+    if (at == sales.months.end() || at->month != month) {
+        at = sales.months.insert(at, MonthSales{month, SalesSummary(settings), SalesSummary(settings)});
+    }
+
+    at->customers.add(order.getBuyerSymbol(), 1);
+    for (const auto& item : order.getItems()) {
+        uint64_t quantity = static_cast<uint64_t>(max(item.getQuantity(), 0));
+        sales.items->add(static_cast<uint32_t>(item.getId()), quantity, item.getNameSymbol());
+        at->items.add(item.getNameSymbol(), quantity);
+    }
+}
+
+// Runs once per store, when it crosses exactLimit.
+void SalesSketches::startSketches(Symbol store, size_t end) {
+    StoreSales& sales = stores[store];
+    sales.items = make_unique<SalesSummary>(settings);
+    for (size_t i = 0; i < end; ++i) {
+        const Order& order = orders[i];
+        if (order.getStatus() == STATUS_DONE && order.getStoreSymbol() == store) {
+            addToSketches(sales, order);
+        }
+    }
+}
+
+// Called with indexed at the order's position.
+void SalesSketches::record(const Order& order) {
+    if (order.getStatus() != STATUS_DONE) return;
+
+    Symbol store = order.getStoreSymbol();
+    if (store >= stores.size()) stores.resize(store + 1);
+    StoreSales& sales = stores[store];
+    sales.doneOrders++;
+
+    if (!sales.items) {
+        if (!wantsSketches(sales)) return;
+        startSketches(store, indexed);
+    }
+    addToSketches(sales, order);
+}
+
+void SalesSketches::refresh() {
+    for (; indexed < orders.size(); ++indexed) {
+        record(orders[indexed]);
+    }
+}
+
+void SalesSketches::truncate(size_t size) {
+    if (size >= indexed) return;
+    stores.clear();
+    indexed = 0;
+}
+
+const StoreSales* SalesSketches::salesOf(const string& storeName) {
+    refresh();
+    Symbol store;
+    if (!symbols.find(storeName, store) || store >= stores.size() || stores[store].doneOrders == 0) {
+        return nullptr;
+    }
+    return &stores[store];
+}
+
+bool SalesSketches::approximate(const StoreSales* sales) const {
+    return sales && wantsSketches(*sales);
+}
@@ -0,0 +1,105 @@
+#ifndef SALES_SKETCH_H
+#define SALES_SKETCH_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "order.h"
+#include "heavy_hitters.h"
+
+using namespace std;
+
+enum TopKMode { TOPK_AUTO, TOPK_EXACT, TOPK_APPROX };
+
+struct SketchSettings {
+    TopKMode mode = TOPK_AUTO;
+    size_t counters = 256;        // Space-Saving counters per summary
+    size_t width = 1024;          // Count-Min counters per row
+    size_t depth = 4;             // Count-Min rows
+    // In TOPK_AUTO, stores with more DONE orders than this are reported
+    // from the sketches; smaller ones keep the exact maps.
+    size_t exactLimit = 100000;
+};
+
+// A key ranked by a summary; its true weight lies in [lower, upper].
+struct TopEstimate {
+    uint32_t key;
+    uint32_t tag;
+    uint64_t upper;
+    uint64_t lower;
+};
+
+// Space-Saving picks the candidates, Count-Min tightens their counts.
+// Memory is fixed by the settings, whatever the number of keys.
+class SalesSummary {
+private:
+    SpaceSaving candidates;
+    CountMinSketch counts;
+
+public:
+    explicit SalesSummary(const SketchSettings& settings);
+
+    void add(uint32_t key, uint64_t weight, uint32_t tag = 0);
+    // The k keys with the largest upper estimates, largest first.
+    vector<TopEstimate> top(size_t k) const;
+
+    uint64_t totalWeight() const { return candidates.totalWeight(); }
+    uint64_t spaceSavingError() const { return candidates.maxError(); }
+    uint64_t countMinError() const { return counts.errorBound(); }
+    double countMinConfidence() const { return counts.confidence(); }
+};
+
+struct MonthSales {
+    int32_t month;                // Order::getMonthKey
+    SalesSummary items;           // quantity sold, by item name
+    SalesSummary customers;       // DONE orders, by buyer
+};
+
+// items is null, and months empty, until the store is reported from its
+// sketches.
+struct StoreSales {
+    uint64_t doneOrders = 0;
+    unique_ptr<SalesSummary> items;   // quantity sold, by item id
+    vector<MonthSales> months;        // by month
+};
+
+// Per-store and per-month sales sketches over the DONE orders of the
+// global order list, kept up to date as orders are appended. Every store's
+// DONE orders are counted, but its sketches are only built once reports on
+// it would read them: in TOPK_APPROX, or in TOPK_AUTO when it passes
+// exactLimit, at which point its earlier orders are added from the list.
+// Sketches cannot forget an order, so shrinking the list drops them all
+// and the next query rebuilds them.
+class SalesSketches {
+private:
+    const vector<Order>& orders;
+    SketchSettings settings;
+    size_t indexed = 0;
+    vector<StoreSales> stores;        // by store symbol
+
+    bool wantsSketches(const StoreSales& sales) const;
+    void addToSketches(StoreSales& sales, const Order& order);
+    // Builds the store's sketches from its DONE orders before position end.
+    void startSketches(Symbol store, size_t end);
+    void record(const Order& order);
+
+public:
+    explicit SalesSketches(const vector<Order>& orders);
+
+    void configure(const SketchSettings& settings);
+    const SketchSettings& getSettings() const { return settings; }
+
+    void refresh();
+    void truncate(size_t size);
+
+    // Sales of the store, or nullptr when it has no DONE orders.
+    const StoreSales* salesOf(const string& storeName);
+    // True when reports on the store should use the sketches.
+    bool approximate(const StoreSales* sales) const;
+};
+
+extern SalesSketches salesSketches;
+
+#endif // SALES_SKETCH_H
@@ -0,0 +1,90 @@
+#include <bit>
+
+#include "symbol_table.h"
+
+using namespace std;
+
+SymbolTable symbols;
+
+SymbolTable::SymbolTable() : published(0) {
+    for (auto& chunk : chunks) chunk.store(nullptr, memory_order_relaxed);
+    lock_guard<mutex> guard(lock);
+    internLocked(string_view());
+}
+
+SymbolTable::~SymbolTable() {
+    for (auto& chunk : chunks) delete[] chunk.load(memory_order_relaxed);
+}
+
+void SymbolTable::locate(Symbol id, size_t& chunk, size_t& offset) {
+    uint64_t n = id / FIRST_CHUNK + 1;
+    chunk = static_cast<size_t>(bit_width(n) - 1);
+    offset = id - FIRST_CHUNK * ((uint64_t(1) << chunk) - 1);
+}
+
+Symbol SymbolTable::internLocked(string_view name) {
+    auto found = ids.find(name);
+    if (found != ids.end()) return found->second;
+
+    Symbol id = published.load(memory_order_relaxed);
+    size_t chunk, offset;
+    locate(id, chunk, offset);
+    string* slots = chunks[chunk].load(memory_order_relaxed);
+    if (!slots) {
+        slots = new string[size_t(FIRST_CHUNK) << chunk];
+        chunks[chunk].store(slots, memory_order_release);
+    }
+    slots[offset] = name;
+    ids.emplace(string_view(slots[offset]), id);
+    // The name is written before the count that makes it readable.
+    published.store(id + 1, memory_order_release);
+    return id;
+}
+
+Symbol SymbolTable::intern(string_view name) {
+    lock_guard<mutex> guard(lock);
+    return internLocked(name);
+}
+
+void SymbolTable::internAll(const deque<string>& names, vector<Symbol>& out) {
+    out.clear();
+    out.reserve(names.size());
+    lock_guard<mutex> guard(lock);
+    for (const auto& name : names) out.push_back(internLocked(name));
+}
+
+bool SymbolTable::find(string_view name, Symbol& id) const {
+    lock_guard<mutex> guard(lock);
+    auto found = ids.find(name);
+    if (found == ids.end()) return false;
+    id = found->second;
+    return true;
+}
+
+const string& SymbolTable::name(Symbol id) const {
+    if (id >= published.load(memory_order_acquire)) id = 0;
+    size_t chunk, offset;
+    locate(id, chunk, offset);
+    return chunks[chunk].load(memory_order_acquire)[offset];
+}
+
+LocalSymbols::LocalSymbols() {
+    names.emplace_back();
+    ids.emplace(string_view(names.back()), 0);
+}
+
+Symbol LocalSymbols::intern(string_view name) {
+    auto found = ids.find(name);
+    if (found != ids.end()) return found->second;
+
+    Symbol id = static_cast<Symbol>(names.size());
+    names.emplace_back(name);
+    ids.emplace(string_view(names.back()), id);
+    return id;
+}
+
+vector<Symbol> LocalSymbols::publish(SymbolTable& table) const {
+    vector<Symbol> global;
+    table.internAll(names, global);
+    return global;
+}
@@ -0,0 +1,77 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+typedef uint32_t Symbol;
+
+// Interned names shared by orders and items: each distinct string is
+// stored once and referred to by a 32-bit id, so equal names have equal
+// ids and compare as integers. Symbol 0 is the empty string.
+//
+// Names live in chunks that never move, each twice the size of the one
+// before, and a name is published by bumping an atomic count after it is
+// written. name() therefore takes no lock; only adding a name and find()
+// do, so the parallel order parse interns into LocalSymbols instead.
+class SymbolTable {
+private:
+    static const uint32_t FIRST_CHUNK = 1024;
+    // Chunk k holds FIRST_CHUNK << k names; 23 chunks cover every Symbol.
+    static const size_t MAX_CHUNKS = 23;
+
+    mutable mutex lock;
+    array<atomic<string*>, MAX_CHUNKS> chunks;
+    atomic<uint32_t> published;
+    unordered_map<string_view, Symbol> ids;
+
+    static void locate(Symbol id, size_t& chunk, size_t& offset);
+    Symbol internLocked(string_view name);
+
+public:
+    SymbolTable();
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    Symbol intern(string_view name);
+
+    // Interns every name under one lock; out[i] is the id of names[i].
+    void internAll(const deque<string>& names, vector<Symbol>& out);
+
+    // Looks a name up without adding it.
+    bool find(string_view name, Symbol& id) const;
+
+    const string& name(Symbol id) const;
+    size_t size() const { return published.load(memory_order_acquire); }
+};
+
+extern SymbolTable symbols;
+
+// Names interned by one thread without the table lock. Ids are local until
+// publish() adds the names to the table and returns the global id of each
+// local one, so a parse split across threads merges its parts in order and
+// hands out the same ids on every run. Local symbol 0 is the empty string.
+class LocalSymbols {
+private:
+    deque<string> names;
+    unordered_map<string_view, Symbol> ids;
+
+public:
+    LocalSymbols();
+
+    Symbol intern(string_view name);
+    vector<Symbol> publish(SymbolTable& table) const;
+};
+
+#endif // SYMBOL_TABLE_H
@@ -0,0 +1,176 @@
+#include <ctime>
+
+#include "civil_time.h"
+
+using namespace std;
+
+int64_t floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+namespace {
+
+// Direct-mapped by day, enough for about a year of distinct days.
+const size_t LOCAL_OFFSET_CACHE_DAYS = 512;
+
+void putDigits(char* out, unsigned value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+bool readDigits(string_view text, size_t pos, int width, unsigned& value) {
+    value = 0;
+    for (int i = 0; i < width; ++i) {
+        char c = text[pos + static_cast<size_t>(i)];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + static_cast<unsigned>(c - '0');
+    }
+    return true;
+}
+
+unsigned daysInMonth(int year, unsigned month) {
+    static const unsigned DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : DAYS[month - 1];
+}
+
+// Asks the C library once; the only call that depends on the tz database.
+int64_t queryLocalOffset(int64_t seconds) {
+    time_t tt = static_cast<time_t>(seconds);
+    tm local{};
+#if defined(_WIN32)
+    if (localtime_s(&local, &tt) != 0) return 0;
+#else
+    if (localtime_r(&tt, &local) == nullptr) return 0;
+#endif
+    int64_t localSeconds = daysFromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1),
+                                         static_cast<unsigned>(local.tm_mday)) * SECONDS_PER_DAY
+                           + local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    return localSeconds - seconds;
+}
+
+} // namespace
+
+// Howard Hinnant's days_from_civil / civil_from_days.
+int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    int64_t y = static_cast<int64_t>(year) - (month <= 2 ? 1 : 0);
+    int64_t era = floorDiv(y, 400);
+    int64_t yearOfEra = y - era * 400;
+    int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+CivilDate civilFromDays(int64_t days) {
+    days += 719468;
+    int64_t era = floorDiv(days, 146097);
+    int64_t dayOfEra = days - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+
+    CivilDate date;
+    date.day = static_cast<unsigned>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    date.month = static_cast<unsigned>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    date.year = static_cast<int>(yearOfEra + era * 400 + (date.month <= 2 ? 1 : 0));
+    return date;
+}
+
+int64_t toUnixSeconds(chrono::system_clock::time_point tp) {
+    return chrono::floor<chrono::seconds>(tp.time_since_epoch()).count();
+}
+
+bool formatCivilTime(int64_t seconds, char* out) {
+    int64_t days = floorDiv(seconds, SECONDS_PER_DAY);
+    int64_t secondOfDay = seconds - days * SECONDS_PER_DAY;
+    CivilDate date = civilFromDays(days);
+    if (date.year < 0 || date.year > 9999) return false;
+
+    putDigits(out, static_cast<unsigned>(date.year), 4);
+    out[4] = '-';
+    putDigits(out + 5, date.month, 2);
+    out[7] = '-';
+    putDigits(out + 8, date.day, 2);
+    out[10] = ' ';
+    putDigits(out + 11, static_cast<unsigned>(secondOfDay / 3600), 2);
+    out[13] = ':';
+    putDigits(out + 14, static_cast<unsigned>(secondOfDay / 60 % 60), 2);
+    out[16] = ':';
+    putDigits(out + 17, static_cast<unsigned>(secondOfDay % 60), 2);
+    return true;
+}
+
+bool parseCivilTime(string_view text, int64_t& seconds) {
+    if (text.size() != CIVIL_TIME_LENGTH) return false;
+    if (text[4] != '-' || text[7] != '-' || text[10] != ' ' || text[13] != ':' || text[16] != ':') {
+        return false;
+    }
+
+    unsigned year, month, day, hour, minute, second;
+    if (!readDigits(text, 0, 4, year) || !readDigits(text, 5, 2, month) ||
+        !readDigits(text, 8, 2, day) || !readDigits(text, 11, 2, hour) ||
+        !readDigits(text, 14, 2, minute) || !readDigits(text, 17, 2, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(static_cast<int>(year), month)) return false;
+    if (hour > 23 || minute > 59 || second > 60) return false;
+
+    seconds = daysFromCivil(static_cast<int>(year), month, day) * SECONDS_PER_DAY
+              + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+int64_t localOffsetSeconds(int64_t seconds) {
+    struct DayOffset {
+        int64_t day = INT64_MIN;
+        int64_t offset = 0;
+        bool uniform = false;
+    };
+    // Per thread, so worker threads never share an entry.
+    thread_local DayOffset cache[LOCAL_OFFSET_CACHE_DAYS];
+
+    int64_t day = floorDiv(seconds, SECONDS_PER_DAY);
+    DayOffset& entry = cache[static_cast<uint64_t>(day) % LOCAL_OFFSET_CACHE_DAYS];
+    if (entry.day != day) {
+        int64_t start = day * SECONDS_PER_DAY;
+        entry.day = day;
+        entry.offset = queryLocalOffset(start);
+        entry.uniform = queryLocalOffset(start + SECONDS_PER_DAY - 1) == entry.offset;
+    }
+    return entry.uniform ? entry.offset : queryLocalOffset(seconds);
+}
+
+bool formatLocalTime(chrono::system_clock::time_point tp, char* out) {
+    int64_t seconds = toUnixSeconds(tp);
+    return formatCivilTime(seconds + localOffsetSeconds(seconds), out);
+}
+
+int64_t localDayNumber(chrono::system_clock::time_point tp) {
+    int64_t seconds = toUnixSeconds(tp);
+    return floorDiv(seconds + localOffsetSeconds(seconds), SECONDS_PER_DAY);
+}
+
+// The offset is taken at the guess and then at the result, so a day whose
+// midnight falls on the other side of a DST change still lands on it.
+int64_t localMidnight(int64_t days) {
+    int64_t local = days * SECONDS_PER_DAY;
+    int64_t seconds = local - localOffsetSeconds(local);
+    return local - localOffsetSeconds(seconds);
+}
+
+int32_t monthNumber(int64_t days) {
+    CivilDate date = civilFromDays(days);
+    return date.year * 12 + static_cast<int32_t>(date.month) - 1;
+}
+
+bool formatYearMonth(int32_t month, char* out) {
+    int64_t year = floorDiv(month, 12);
+    if (year < 0 || year > 9999) return false;
+    putDigits(out, static_cast<unsigned>(year), 4);
+    out[4] = '-';
+    putDigits(out + 5, static_cast<unsigned>(month - year * 12 + 1), 2);
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef CIVIL_TIME_H
+#define CIVIL_TIME_H
+
+#include <chrono>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Codec for "YYYY-MM-DD HH:MM:SS" timestamps on a proleptic Gregorian
+// calendar. Conversions are plain integer arithmetic on days since
+// 1970-01-01 and write into caller buffers, so formatting or parsing a
+// record neither allocates nor touches the locale or the tz database.
+const size_t CIVIL_TIME_LENGTH = 19;
+const int64_t SECONDS_PER_DAY = 86400;
+
+// Floor division, so instants before 1970 land on the right day.
+int64_t floorDiv(int64_t value, int64_t divisor);
+
+struct CivilDate {
+    int year;
+    unsigned month;
+    unsigned day;
+};
+
+int64_t daysFromCivil(int year, unsigned month, unsigned day);
+CivilDate civilFromDays(int64_t days);
+
+int64_t toUnixSeconds(chrono::system_clock::time_point tp);
+
+// Writes exactly CIVIL_TIME_LENGTH characters for UTC seconds. Returns false,
+// writing nothing, when the year does not fit in four digits.
+bool formatCivilTime(int64_t seconds, char* out);
+
+// Accepts exactly the format above, read as UTC.
+bool parseCivilTime(string_view text, int64_t& seconds);
+
+// Offset of local time from UTC at the given instant. The offset is looked
+// up once per UTC day and cached unless the day has a DST change.
+int64_t localOffsetSeconds(int64_t seconds);
+
+bool formatLocalTime(chrono::system_clock::time_point tp, char* out);
+
+// Local calendar day of the instant, in days since 1970-01-01.
+int64_t localDayNumber(chrono::system_clock::time_point tp);
+
+// Unix seconds at which the local day starts.
+int64_t localMidnight(int64_t days);
+
+// Month of a day number as year * 12 + month - 1, so consecutive months
+// are consecutive integers.
+int32_t monthNumber(int64_t days);
+
+// Writes exactly YEAR_MONTH_LENGTH characters, "YYYY-MM". Returns false,
+// writing nothing, when the year does not fit in four digits.
+const size_t YEAR_MONTH_LENGTH = 7;
+bool formatYearMonth(int32_t month, char* out);
+
+#endif // CIVIL_TIME_H
@@ -0,0 +1,62 @@
+#ifndef CSV_CODEC_H
+#define CSV_CODEC_H
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+using namespace std;
+
+// Number fields of the CSV records. Values are written with to_chars and
+// read with from_chars: no stream, no locale, and a bad field is reported
+// through the return value instead of an exception.
+
+// Doubles come out as the shortest plain decimal that reads back as the
+// same value (100000, not 1e+05); huge magnitudes fall back to an exponent.
+template <typename T>
+void appendNumber(string& out, T value) {
+    char buffer[64];
+    to_chars_result result;
+    if constexpr (is_floating_point_v<T>) {
+        result = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed);
+        if (result.ec != errc()) {
+            result = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::general);
+        }
+    } else {
+        result = to_chars(buffer, buffer + sizeof(buffer), value);
+    }
+    out.append(buffer, result.ptr);
+}
+
+inline void appendFixed(string& out, double value, int precision) {
+    char buffer[64];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed, precision);
+    if (result.ec == errc()) {
+        out.append(buffer, result.ptr);
+    } else {
+        appendNumber(out, value);
+    }
+}
+
+// Reads the number at the start of the field. Like stoi/stod, text after the
+// number is ignored: in order rows the item fields run into the next item
+// after a ';'.
+template <typename T>
+bool parseNumber(string_view field, T& value) {
+    const char* first = field.data();
+    const char* last = field.data() + field.size();
+    while (first != last && (*first == ' ' || *first == '\t')) ++first;
+    if (first != last && *first == '+') ++first;
+
+    from_chars_result result;
+    if constexpr (is_floating_point_v<T>) {
+        result = from_chars(first, last, value, chars_format::general);
+    } else {
+        result = from_chars(first, last, value);
+    }
+    return result.ec == errc() && result.ptr != first;
+}
+
+#endif // CSV_CODEC_H
@@ -0,0 +1,267 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#include "ledger.h"
+#include "mapped_file.h"
+#include "snapshot_files.h"
+#include "civil_time.h"
+#include "csv_codec.h"
+#include "lz_codec.h"
+
+using namespace std;
+
+namespace {
+
+const char SEGMENT_MAGIC[4] = {'L', 'S', 'E', 'G'};
+const uint32_t SEGMENT_VERSION = 1;
+const size_t SEGMENT_HEADER = sizeof(SEGMENT_MAGIC) + sizeof(uint32_t) + sizeof(uint64_t);
+const string MANIFEST_NAME = "MANIFEST";
+
+string ledgerDir(const string& activePath) {
+    filesystem::path path(activePath);
+    return (path.parent_path() / (path.stem().string() + ".ledger")).string();
+}
+
+string segmentFile(const string& dir, uint64_t sequence) {
+    char name[32];
+    snprintf(name, sizeof(name), "seg-%06llu.lz", static_cast<unsigned long long>(sequence));
+    return dir + "/" + name;
+}
+
+int monthOf(int64_t seconds) {
+    return monthNumber(floorDiv(seconds, SECONDS_PER_DAY));
+}
+
+// Account id and time of one row, without building a BankTransaction.
+bool rowKey(string_view line, vector<string_view>& tokens, int& accountId, int64_t& seconds) {
+    splitView(line, ',', tokens);
+    return tokens.size() >= 5 && parseNumber(tokens[0], accountId) && parseCivilTime(tokens[1], seconds);
+}
+
+// Rows of a segment that lies wholly inside the window with no account
+// filter are taken without checking their keys first.
+void collectRows(string_view text, int64_t from, int64_t to, int accountId, bool takeAll,
+                 vector<BankTransaction>& out) {
+    vector<string_view> tokens;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        if (end == string_view::npos) end = text.size();
+        string_view line = text.substr(pos, end - pos);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        pos = end + 1;
+
+        if (takeAll) {
+            splitView(line, ',', tokens);
+        } else {
+            int rowAccount;
+            int64_t seconds;
+            if (!rowKey(line, tokens, rowAccount, seconds)) continue;
+            if (seconds < from || seconds > to) continue;
+            if (accountId != 0 && rowAccount != accountId) continue;
+        }
+
+        BankTransaction t = BankTransaction::fromCSV(tokens);
+        if (t.accountId > 0) out.push_back(t);
+    }
+}
+
+void addStats(JournalStats& total, const JournalStats& part) {
+    total.records += part.records;
+    total.groups += part.groups;
+    total.appendMicros += part.appendMicros;
+    total.maxAppendMicros = max(total.maxAppendMicros, part.maxAppendMicros);
+    total.commitMicros += part.commitMicros;
+    total.elapsedSeconds += part.elapsedSeconds;
+}
+
+} // namespace
+
+bool LedgerSegment::overlaps(int64_t from, int64_t to, int accountId) const {
+    if (rows == 0 || lastTime < from || firstTime > to) return false;
+    return accountId == 0 || (minAccount <= accountId && accountId <= maxAccount);
+}
+
+bool LedgerSegment::covers(int64_t from, int64_t to, int accountId) const {
+    return accountId == 0 && from <= firstTime && lastTime <= to;
+}
+
+TransactionLedger::TransactionLedger(const string& activePath, const JournalSettings& settings)
+    : activePath(activePath), dir(ledgerDir(activePath)), settings(settings), activeMonth(-1) {
+    openActive();
+}
+
+void TransactionLedger::openActive() {
+    ifstream manifest(dir + "/" + MANIFEST_NAME);
+    LedgerSegment segment;
+    while (manifest >> segment.sequence >> segment.firstTime >> segment.lastTime
+                    >> segment.minAccount >> segment.maxAccount >> segment.rows
+                    >> segment.rawBytes >> segment.storedBytes >> segment.checksum) {
+        sealed.push_back(segment);
+    }
+
+    {
+        MappedFile file(activePath);
+        string_view text = file.view();
+
+        // A crash between sealing and emptying the active file leaves the
+        // sealed rows at its start; drop them instead of counting them twice.
+        if (!sealed.empty() && sealed.back().rawBytes > 0 && text.size() >= sealed.back().rawBytes &&
+            blockChecksum(text.substr(0, sealed.back().rawBytes)) == sealed.back().checksum) {
+            string rest(text.substr(sealed.back().rawBytes));
+            ofstream ofs(activePath + ".tmp", ios::binary);
+            ofs.write(rest.data(), static_cast<streamsize>(rest.size()));
+            ofs.close();
+            commitSnapshot(activePath);
+        }
+    }
+
+    MappedFile file(activePath);
+    vector<string_view> tokens;
+    file.forEachLine([&](string_view line) {
+        int accountId;
+        int64_t seconds;
+        if (rowKey(line, tokens, accountId, seconds)) {
+            if (active.rows == 0) activeMonth = monthOf(seconds);
+            track(active, seconds, accountId, 0);
+        }
+    });
+    active.rawBytes = file.view().size();
+}
+
+void TransactionLedger::track(LedgerSegment& segment, int64_t seconds, int accountId, size_t bytes) {
+    if (segment.rows == 0) {
+        segment.firstTime = segment.lastTime = seconds;
+        segment.minAccount = segment.maxAccount = accountId;
+    } else {
+        segment.firstTime = min(segment.firstTime, seconds);
+        segment.lastTime = max(segment.lastTime, seconds);
+        segment.minAccount = min(segment.minAccount, accountId);
+        segment.maxAccount = max(segment.maxAccount, accountId);
+    }
+    segment.rows++;
+    segment.rawBytes += bytes;
+}
+
+void TransactionLedger::append(const BankTransaction& t) {
+    int64_t seconds = toUnixSeconds(t.timestamp);
+    int month = monthOf(seconds);
+    if (active.rows > 0 && (month != activeMonth || active.rawBytes >= MAX_ACTIVE_BYTES)) {
+        seal();
+    }
+    // Opened on the first write, so reading a ledger never creates files.
+    if (!journal) journal = make_unique<TransactionJournal>(activePath, settings);
+    if (!journal->isOpen()) return;
+
+    string line;
+    t.appendCSV(line);
+    journal->append(line);
+    if (active.rows == 0) activeMonth = month;
+    track(active, seconds, t.accountId, line.size() + 1);
+}
+
+void TransactionLedger::seal() {
+    if (journal) {
+        addStats(retired, journal->stats());
+        journal.reset();
+    }
+
+    error_code ec;
+    filesystem::create_directories(dir, ec);
+
+    LedgerSegment segment = active;
+    segment.sequence = sealed.empty() ? 1 : sealed.back().sequence + 1;
+    string path = segmentFile(dir, segment.sequence);
+    bool written = false;
+    {
+        MappedFile file(activePath);
+        string_view raw = file.view();
+        string packed = lzCompress(raw);
+
+        segment.rawBytes = raw.size();
+        segment.storedBytes = SEGMENT_HEADER + packed.size();
+        segment.checksum = blockChecksum(raw);
+
+        ofstream ofs(path + ".tmp", ios::binary);
+        if (ofs.is_open()) {
+            uint64_t rawSize = raw.size();
+            ofs.write(SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+            ofs.write(reinterpret_cast<const char*>(&SEGMENT_VERSION), sizeof(SEGMENT_VERSION));
+            ofs.write(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+            ofs.write(packed.data(), static_cast<streamsize>(packed.size()));
+            written = ofs.good();
+        }
+    }
+
+    if (written) {
+        commitSnapshot(path);
+        sealed.push_back(segment);
+        writeManifest();
+        filesystem::resize_file(activePath, 0, ec);
+        active = LedgerSegment{};
+        activeMonth = -1;
+    } else {
+        cerr << "ERROR: Could not seal " << activePath << " into " << path << ".\n";
+    }
+
+}
+
+void TransactionLedger::writeManifest() const {
+    string path = dir + "/" + MANIFEST_NAME;
+    {
+        ofstream ofs(path + ".tmp");
+        for (const auto& segment : sealed) {
+            ofs << segment.sequence << " " << segment.firstTime << " " << segment.lastTime << " "
+                << segment.minAccount << " " << segment.maxAccount << " " << segment.rows << " "
+                << segment.rawBytes << " " << segment.storedBytes << " " << segment.checksum << "\n";
+        }
+    }
+    commitSnapshot(path);
+}
+
+void TransactionLedger::flush() {
+    if (journal) journal->flush();
+}
+
+// Counted over every journal the ledger has had, across seals.
+JournalStats TransactionLedger::stats() {
+    JournalStats total = retired;
+    if (journal) addStats(total, journal->stats());
+    return total;
+}
+
+vector<BankTransaction> TransactionLedger::load(int64_t from, int64_t to, int accountId) {
+    vector<BankTransaction> rows;
+
+    string raw;
+    for (const auto& segment : sealed) {
+        if (!segment.overlaps(from, to, accountId)) continue;
+
+        string path = segmentFile(dir, segment.sequence);
+        MappedFile file(path);
+        string_view data = file.view();
+        uint32_t version = 0;
+        uint64_t rawSize = 0;
+        if (data.size() >= SEGMENT_HEADER && memcmp(data.data(), SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0) {
+            memcpy(&version, data.data() + sizeof(SEGMENT_MAGIC), sizeof(version));
+            memcpy(&rawSize, data.data() + sizeof(SEGMENT_MAGIC) + sizeof(version), sizeof(rawSize));
+        }
+        if (version != SEGMENT_VERSION || !lzDecompress(data.substr(SEGMENT_HEADER), rawSize, raw) ||
+            blockChecksum(raw) != segment.checksum) {
+            cerr << "Warning: Ledger segment " << path << " is missing or corrupt.\n";
+            continue;
+        }
+        collectRows(raw, from, to, accountId, segment.covers(from, to, accountId), rows);
+    }
+
+    flush();
+    if (active.overlaps(from, to, accountId)) {
+        MappedFile file(activePath);
+        collectRows(file.view(), from, to, accountId, active.covers(from, to, accountId), rows);
+    }
+    return rows;
+}
@@ -0,0 +1,69 @@
+#ifndef LEDGER_H
+#define LEDGER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+#include "transaction_journal.h"
+#include "bank_transaction.h"
+
+using namespace std;
+
+// Time and account range of one ledger segment, as kept in the manifest.
+struct LedgerSegment {
+    uint64_t sequence = 0;
+    int64_t firstTime = 0;     // UTC seconds
+    int64_t lastTime = 0;
+    int minAccount = 0;
+    int maxAccount = 0;
+    uint64_t rows = 0;
+    uint64_t rawBytes = 0;
+    uint64_t storedBytes = 0;
+    uint32_t checksum = 0;     // of the raw CSV text
+
+    bool overlaps(int64_t from, int64_t to, int accountId) const;
+    bool covers(int64_t from, int64_t to, int accountId) const;
+};
+
+// Transaction ledger split by time. New rows go through a journal into the
+// active CSV file (the path the ledger was opened with). When a row falls in
+// a new calendar month, or the active file passes the size limit, the file
+// is sealed: compressed into <stem>.ledger/seg-NNNNNN.lz, recorded in the
+// manifest there, and emptied.
+class TransactionLedger {
+private:
+    string activePath;
+    string dir;
+    JournalSettings settings;
+    unique_ptr<TransactionJournal> journal;
+    JournalStats retired;
+    vector<LedgerSegment> sealed;
+    LedgerSegment active;
+    int activeMonth;
+
+    void openActive();
+    void seal();
+    void writeManifest() const;
+    void track(LedgerSegment& segment, int64_t seconds, int accountId, size_t bytes);
+
+public:
+    static const uint64_t MAX_ACTIVE_BYTES = uint64_t(16) << 20;
+
+    TransactionLedger(const string& activePath, const JournalSettings& settings);
+
+    void append(const BankTransaction& t);
+    void flush();
+    JournalStats stats();
+
+    // Rows with a timestamp in [from, to] (UTC seconds) and, unless accountId
+    // is 0, of that account. Segments outside the window are not read.
+    vector<BankTransaction> load(int64_t from, int64_t to, int accountId);
+
+    const vector<LedgerSegment>& segments() const { return sealed; }
+};
+
+#endif // LEDGER_H
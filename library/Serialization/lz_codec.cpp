@@ -0,0 +1,152 @@
+#include <vector>
+#include <cstring>
+
+#include "lz_codec.h"
+
+using namespace std;
+
+namespace {
+
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 14;
+// Matches never start this close to the end, so the last bytes are always
+// literals and the 4-byte reads below stay inside the input.
+const size_t END_LITERALS = 8;
+
+uint32_t read32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashOf(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void putLength(string& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+void putSequence(string& out, string_view literals, size_t matchLength, size_t offset) {
+    size_t literalNibble = literals.size() < 15 ? literals.size() : 15;
+    size_t matchNibble = 0;
+    if (matchLength > 0) {
+        matchNibble = (matchLength - MIN_MATCH) < 15 ? matchLength - MIN_MATCH : 15;
+    }
+    out.push_back(static_cast<char>((literalNibble << 4) | matchNibble));
+    if (literalNibble == 15) putLength(out, literals.size() - 15);
+    out.append(literals);
+
+    if (matchLength == 0) return;
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (matchNibble == 15) putLength(out, matchLength - MIN_MATCH - 15);
+}
+
+bool getLength(string_view input, size_t& pos, size_t& length) {
+    while (true) {
+        if (pos >= input.size()) return false;
+        unsigned char byte = static_cast<unsigned char>(input[pos++]);
+        length += byte;
+        if (byte != 255) return true;
+    }
+}
+
+} // namespace
+
+string lzCompress(string_view input) {
+    string out;
+    out.reserve(input.size() / 2 + 16);
+
+    vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+    const char* base = input.data();
+    size_t anchor = 0;
+    size_t pos = 0;
+    size_t limit = input.size() > END_LITERALS ? input.size() - END_LITERALS : 0;
+
+    while (pos < limit) {
+        uint32_t sequence = read32(base + pos);
+        uint32_t& slot = table[hashOf(sequence)];
+        // Slots hold position + 1, so 0 means empty.
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || read32(base + candidate - 1) != sequence) {
+            ++pos;
+            continue;
+        }
+        size_t match = candidate - 1;
+
+        size_t length = MIN_MATCH;
+        while (pos + length < limit && base[match + length] == base[pos + length]) ++length;
+
+        putSequence(out, input.substr(anchor, pos - anchor), length, pos - match);
+        pos += length;
+        anchor = pos;
+    }
+
+    putSequence(out, input.substr(anchor), 0, 0);
+    return out;
+}
+
+bool lzDecompress(string_view input, size_t rawSize, string& out) {
+    out.clear();
+    out.resize(rawSize);
+    size_t written = 0;
+    size_t pos = 0;
+
+    while (pos < input.size()) {
+        unsigned char token = static_cast<unsigned char>(input[pos++]);
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !getLength(input, pos, literals)) return false;
+        if (literals > input.size() - pos || literals > rawSize - written) return false;
+        memcpy(&out[written], input.data() + pos, literals);
+        pos += literals;
+        written += literals;
+
+        if (pos == input.size()) break;
+
+        if (input.size() - pos < 2) return false;
+        size_t offset = static_cast<unsigned char>(input[pos]) |
+                        (static_cast<size_t>(static_cast<unsigned char>(input[pos + 1])) << 8);
+        pos += 2;
+        size_t length = token & 0x0F;
+        if (length == 15 && !getLength(input, pos, length)) return false;
+        length += MIN_MATCH;
+
+        if (offset == 0 || offset > written || length > rawSize - written) return false;
+        size_t from = written - offset;
+        if (offset >= length) {
+            memcpy(&out[written], &out[from], length);
+        } else {
+            // The match overlaps the bytes it produces; copy byte by byte.
+            for (size_t i = 0; i < length; ++i) {
+                out[written + i] = out[from + i];
+            }
+        }
+        written += length;
+    }
+    return written == rawSize;
+}
+
+// FNV-1a over 8-byte words, with a shift to fold the high bits back in.
+uint32_t blockChecksum(string_view data) {
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data.data() + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < data.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    }
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
@@ -0,0 +1,27 @@
+#ifndef LZ_CODEC_H
+#define LZ_CODEC_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+using namespace std;
+
+// Small LZ77 block codec for cold files, in the spirit of LZ4: a stream of
+// sequences, each a run of literal bytes followed by a back-reference of at
+// least four bytes within the previous 64 KiB. It needs no dictionary or
+// external library and decodes at memory speed, which is what the sealed
+// ledger segments need; the ratio on CSV text is typically 3-5x.
+//
+// Sequence: token (literal length << 4 | match length - 4), extra length
+// bytes when a nibble is 15, the literals, then a 16-bit little-endian
+// offset and extra match length bytes. The last sequence has no match.
+string lzCompress(string_view input);
+
+// Fails on malformed input or when the output is not exactly rawSize bytes.
+bool lzDecompress(string_view input, size_t rawSize, string& out);
+
+// Checksum for whole blocks, fast enough to verify every decoded segment.
+uint32_t blockChecksum(string_view data);
+
+#endif // LZ_CODEC_H
@@ -0,0 +1,101 @@
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+using namespace std;
+
+MappedFile::MappedFile(const string& path)
+    : data(nullptr), length(0), opened(false), mapped(false) {
+#if !defined(_WIN32)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st{};
+    if (fstat(fd, &st) == 0) {
+        opened = true;
+        length = static_cast<size_t>(st.st_size);
+        fileIdentity.device = static_cast<uint64_t>(st.st_dev);
+        fileIdentity.inode = static_cast<uint64_t>(st.st_ino);
+        if (length > 0) {
+            void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                madvise(addr, length, MADV_SEQUENTIAL);
+                data = static_cast<const char*>(addr);
+                mapped = true;
+            } else {
+                length = 0;
+                opened = false;
+            }
+        }
+    }
+    close(fd);
+#else
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) return;
+
+    stringstream buffer;
+    buffer << ifs.rdbuf();
+    fallback = buffer.str();
+    data = fallback.data();
+    length = fallback.size();
+    opened = true;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+    }
+#endif
+}
+
+void MappedFile::release([[maybe_unused]] size_t from, [[maybe_unused]] size_t to) {
+#if !defined(_WIN32)
+    if (!mapped) return;
+
+    // Only whole pages inside the range; the neighbours may still be in use.
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t first = (from + page - 1) / page * page;
+    size_t last = to / page * page;
+    if (last > first) {
+        madvise(const_cast<char*>(data) + first, last - first, MADV_DONTNEED);
+    }
+#endif
+}
+
+vector<size_t> MappedFile::lineAlignedBounds(size_t parts, size_t begin) const {
+    vector<size_t> bounds{begin};
+    string_view text = view();
+    size_t span = text.size() - min(begin, text.size());
+    for (size_t i = 1; i < parts; ++i) {
+        size_t cut = max(bounds.back(), begin + span * i / parts);
+        size_t newline = text.find('\n', cut);
+        if (newline == string_view::npos) break;
+        if (newline + 1 > bounds.back()) bounds.push_back(newline + 1);
+    }
+    if (bounds.back() != text.size()) bounds.push_back(text.size());
+    return bounds;
+}
+
+void splitView(string_view line, char delimiter, vector<string_view>& tokens) {
+    tokens.clear();
+    size_t start = 0;
+    while (start < line.size()) {
+        size_t end = line.find(delimiter, start);
+        if (end == string_view::npos) {
+            tokens.push_back(line.substr(start));
+            return;
+        }
+        tokens.push_back(line.substr(start, end - start));
+        start = end + 1;
+    }
+}
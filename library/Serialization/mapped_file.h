@@ -0,0 +1,81 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// Device and inode of a file; a file replaced by rename gets a new identity.
+// Stays zero on platforms without inodes.
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+
+    bool operator==(const FileIdentity&) const = default;
+};
+
+// Read-only image of a whole file. On POSIX the file is mmap'd so the loaders
+// can tokenize straight out of the page cache; other platforms read it once.
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+    bool opened;
+    bool mapped;
+    string fallback;
+    FileIdentity fileIdentity;
+
+public:
+    explicit MappedFile(const string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    string_view view() const { return string_view(data, length); }
+    FileIdentity identity() const { return fileIdentity; }
+
+    // Drops the pages of [from, to) from the resident set once they have
+    // been parsed, so a big file never sits in RSS next to its parsed rows.
+    void release(size_t from, size_t to);
+
+    // Calls fn(line) for every non-empty line starting in [begin, end) (a
+    // trailing '\r' is dropped). Ranges cut at newlines can be parsed by
+    // separate threads.
+    template <typename Fn>
+    void forEachLine(Fn fn, size_t begin = 0, size_t end = string_view::npos) {
+        const size_t releaseStep = size_t(8) << 20;
+        string_view text = view().substr(0, min(end, length));
+        size_t released = begin;
+        size_t pos = begin;
+        while (pos < text.size()) {
+            size_t lineEnd = text.find('\n', pos);
+            if (lineEnd == string_view::npos) lineEnd = text.size();
+
+            string_view line = text.substr(pos, lineEnd - pos);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (!line.empty()) fn(line);
+
+            pos = lineEnd + 1;
+            if (pos - released >= releaseStep) {
+                release(released, pos);
+                released = pos;
+            }
+        }
+    }
+
+    // Cuts [begin, size) into up to parts ranges that all end on a newline.
+    vector<size_t> lineAlignedBounds(size_t parts, size_t begin = 0) const;
+};
+
+// Splits one line into views on the line itself. The vector is reused by the
+// caller between rows so tokenizing does not allocate once it has grown.
+void splitView(string_view line, char delimiter, vector<string_view>& tokens);
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,293 @@
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <chrono>
+
+#include "order_columns.h"
+#include "mapped_file.h"
+#include "lz_codec.h"
+#include "../Item/order.h"
+#include "../Item/item.h"
+
+using namespace std;
+
+namespace {
+
+const char ORDER_COLUMNS_MAGIC[4] = {'O', 'C', 'O', 'L'};
+const size_t HEADER_SIZE = sizeof(ORDER_COLUMNS_MAGIC) + sizeof(uint32_t);
+// Oldest version still read: its groups have no length or checksum.
+const uint32_t ORDER_COLUMNS_V1 = 1;
+
+template <typename T>
+void putValue(string& buf, T value) {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void putArray(string& buf, const vector<T>& values) {
+    buf.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+void putStrings(string& buf, const StringColumn& column) {
+    putArray(buf, column.offsets);
+    buf.append(column.bytes);
+}
+
+// Every column is prefixed with its length so readers can jump over it.
+template <typename Fn>
+void putColumn(string& buf, Fn writeBody) {
+    size_t lengthAt = buf.size();
+    putValue<uint64_t>(buf, 0);
+    writeBody();
+    uint64_t length = buf.size() - lengthAt - sizeof(uint64_t);
+    memcpy(&buf[lengthAt], &length, sizeof(length));
+}
+
+string encodeRowGroup(const vector<Order>& orders) {
+    OrderColumns c;
+    c.rows = orders.size();
+    for (const auto& order : orders) {
+        c.id.push_back(order.getOrderId());
+        c.buyer.push_back(order.getBuyerName());
+        c.store.push_back(order.getSellerStoreName());
+        c.total.push_back(order.getTotalAmount());
+        c.status.push_back(order.getStatusName());
+        c.timestamp.push_back(chrono::system_clock::to_time_t(order.getCreationTime()));
+        for (const auto& item : order.getItems()) {
+            c.itemId.push_back(item.getId());
+            c.itemName.push_back(item.getName());
+            c.itemQuantity.push_back(item.getQuantity());
+            c.itemPrice.push_back(item.getPrice());
+        }
+        c.itemOffsets.push_back(static_cast<uint32_t>(c.itemId.size()));
+    }
+
+    string buf;
+    putValue<uint32_t>(buf, static_cast<uint32_t>(c.rows));
+    putValue<uint32_t>(buf, static_cast<uint32_t>(c.itemId.size()));
+    // Body length and checksum, filled in once the columns are written.
+    size_t sealAt = buf.size();
+    putValue<uint64_t>(buf, 0);
+    putValue<uint32_t>(buf, 0);
+    size_t bodyAt = buf.size();
+    putColumn(buf, [&] { putArray(buf, c.id); });
+    putColumn(buf, [&] { putStrings(buf, c.buyer); });
+    putColumn(buf, [&] { putStrings(buf, c.store); });
+    putColumn(buf, [&] { putArray(buf, c.total); });
+    putColumn(buf, [&] { putStrings(buf, c.status); });
+    putColumn(buf, [&] { putArray(buf, c.timestamp); });
+    putColumn(buf, [&] {
+        putArray(buf, c.itemOffsets);
+        putArray(buf, c.itemId);
+        putStrings(buf, c.itemName);
+        putArray(buf, c.itemQuantity);
+        putArray(buf, c.itemPrice);
+    });
+
+    uint64_t bodyLength = buf.size() - bodyAt;
+    uint32_t sum = blockChecksum(string_view(buf).substr(bodyAt));
+    memcpy(&buf[sealAt], &bodyLength, sizeof(bodyLength));
+    memcpy(&buf[sealAt + sizeof(bodyLength)], &sum, sizeof(sum));
+    return buf;
+}
+
+string encodeHeader() {
+    string buf(ORDER_COLUMNS_MAGIC, sizeof(ORDER_COLUMNS_MAGIC));
+    putValue<uint32_t>(buf, ORDER_COLUMNS_VERSION);
+    return buf;
+}
+
+// Bounds-checked cursor over the mapped file.
+struct Reader {
+    string_view data;
+    size_t pos = 0;
+    bool ok = true;
+
+    bool need(size_t n) {
+        if (!ok || data.size() - pos < n) ok = false;
+        return ok;
+    }
+    template <typename T>
+    T value() {
+        T v{};
+        if (need(sizeof(T))) {
+            memcpy(&v, data.data() + pos, sizeof(T));
+            pos += sizeof(T);
+        }
+        return v;
+    }
+    template <typename T>
+    void array(vector<T>& out, size_t count) {
+        if (!need(count * sizeof(T))) return;
+        size_t old = out.size();
+        out.resize(old + count);
+        memcpy(out.data() + old, data.data() + pos, count * sizeof(T));
+        pos += count * sizeof(T);
+    }
+    // Offsets must start at 0, never decrease and end inside the data.
+    bool offsetsValid(const vector<uint32_t>& offsets) {
+        if (!ok) return false;
+        if (offsets.empty() || offsets.front() != 0) ok = false;
+        for (size_t i = 1; ok && i < offsets.size(); ++i) {
+            if (offsets[i] < offsets[i - 1]) ok = false;
+        }
+        return ok;
+    }
+    void strings(StringColumn& out, size_t count) {
+        vector<uint32_t> offsets;
+        array(offsets, count + 1);
+        if (!offsetsValid(offsets) || !need(offsets.back())) return;
+
+        uint32_t base = static_cast<uint32_t>(out.bytes.size());
+        for (size_t i = 1; i <= count; ++i) {
+            out.offsets.push_back(base + offsets[i]);
+        }
+        out.bytes.append(data.data() + pos, offsets.back());
+        pos += offsets.back();
+    }
+};
+
+} // namespace
+
+bool writeOrderColumns(const string& path, const vector<Order>& orders) {
+    ofstream ofs(path, ios::binary | ios::trunc);
+    if (!ofs.is_open()) return false;
+
+    string header = encodeHeader();
+    string group = encodeRowGroup(orders);
+    ofs.write(header.data(), static_cast<streamsize>(header.size()));
+    ofs.write(group.data(), static_cast<streamsize>(group.size()));
+    return ofs.good();
+}
+
+bool appendOrderColumns(const string& path, const vector<Order>& orders) {
+    if (orders.empty()) return true;
+
+    bool fresh;
+    {
+        ifstream probe(path, ios::binary | ios::ate);
+        fresh = !probe.is_open() || probe.tellg() <= 0;
+    }
+
+    ofstream ofs(path, ios::binary | ios::app);
+    if (!ofs.is_open()) return false;
+
+    if (fresh) {
+        string header = encodeHeader();
+        ofs.write(header.data(), static_cast<streamsize>(header.size()));
+    }
+    string group = encodeRowGroup(orders);
+    ofs.write(group.data(), static_cast<streamsize>(group.size()));
+    return ofs.good();
+}
+
+bool readOrderColumns(const string& path, OrderColumns& out) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        out = OrderColumns{};
+        return false;
+    }
+
+    uint64_t offset = 0;
+    return readOrderColumns(path, file.view(), out, offset);
+}
+
+bool readOrderColumns(const string& path, string_view data, OrderColumns& out, uint64_t& offset) {
+    out = OrderColumns{};
+
+    Reader in{data};
+    if (!in.need(HEADER_SIZE) || memcmp(in.data.data(), ORDER_COLUMNS_MAGIC, sizeof(ORDER_COLUMNS_MAGIC)) != 0) {
+        cerr << "Warning: " << path << " is not an order column file.\n";
+        return false;
+    }
+    in.pos = sizeof(ORDER_COLUMNS_MAGIC);
+    uint32_t version = in.value<uint32_t>();
+    if (version != ORDER_COLUMNS_VERSION && version != ORDER_COLUMNS_V1) {
+        cerr << "Warning: " << path << " has unsupported version " << version << ".\n";
+        return false;
+    }
+    out.version = version;
+    if (offset > in.pos) {
+        if (offset > in.data.size()) return false;
+        in.pos = static_cast<size_t>(offset);
+    }
+
+    while (in.ok && in.pos < in.data.size()) {
+        uint32_t rows = in.value<uint32_t>();
+        uint32_t itemRows = in.value<uint32_t>();
+        uint32_t itemBase = out.itemOffsets.back();
+
+        size_t groupEnd = in.data.size();
+        if (version != ORDER_COLUMNS_V1) {
+            uint64_t bodyLength = in.value<uint64_t>();
+            uint32_t sum = in.value<uint32_t>();
+            if (!in.need(bodyLength)) break;
+            if (blockChecksum(in.data.substr(in.pos, bodyLength)) != sum) {
+                in.ok = false;
+                break;
+            }
+            groupEnd = in.pos + bodyLength;
+        }
+
+        for (uint32_t column = COL_ID; column < COL_COUNT && in.ok; ++column) {
+            uint64_t length = in.value<uint64_t>();
+            if (!in.need(length)) break;
+
+            size_t end = in.pos + length;
+            switch (column) {
+                case COL_ID:        in.array(out.id, rows); break;
+                case COL_BUYER:     in.strings(out.buyer, rows); break;
+                case COL_STORE:     in.strings(out.store, rows); break;
+                case COL_TOTAL:     in.array(out.total, rows); break;
+                case COL_STATUS:    in.strings(out.status, rows); break;
+                case COL_TIMESTAMP: in.array(out.timestamp, rows); break;
+                case COL_ITEMS: {
+                    // Item offsets index this group's item columns, so they
+                    // must end exactly at itemRows.
+                    vector<uint32_t> offsets;
+                    in.array(offsets, rows + 1);
+                    if (!in.offsetsValid(offsets) || offsets.back() != itemRows) {
+                        in.ok = false;
+                        break;
+                    }
+                    for (size_t i = 1; i < offsets.size(); ++i) {
+                        out.itemOffsets.push_back(itemBase + offsets[i]);
+                    }
+                    in.array(out.itemId, itemRows);
+                    in.strings(out.itemName, itemRows);
+                    in.array(out.itemQuantity, itemRows);
+                    in.array(out.itemPrice, itemRows);
+                    break;
+                }
+            }
+            if (in.pos != end) in.ok = false;
+        }
+        if (version != ORDER_COLUMNS_V1 && in.pos != groupEnd) in.ok = false;
+        if (in.ok) out.rows += rows;
+    }
+
+    if (!in.ok) {
+        cerr << "Warning: " << path << " is truncated or corrupt.\n";
+        return false;
+    }
+    offset = in.pos;
+    return true;
+}
+
+void materializeOrders(const OrderColumns& columns, vector<Order>& orders) {
+    orders.reserve(orders.size() + columns.rows);
+    for (size_t i = 0; i < columns.rows; ++i) {
+        // Rows with an unknown status are skipped, as in the CSV reader.
+        OrderStatus status;
+        if (!parseOrderStatus(columns.status.at(i), status)) continue;
+
+        vector<Item> items;
+        for (uint32_t j = columns.itemOffsets[i]; j < columns.itemOffsets[i + 1]; ++j) {
+            items.emplace_back(columns.itemId[j], columns.itemName.at(j),
+                               columns.itemQuantity[j], columns.itemPrice[j]);
+        }
+        orders.emplace_back(columns.id[i], symbols.intern(columns.buyer.at(i)), symbols.intern(columns.store.at(i)),
+                            columns.total[i], status, move(items),
+                            chrono::system_clock::from_time_t(columns.timestamp[i]));
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef ORDER_COLUMNS_H
+#define ORDER_COLUMNS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+class Order;
+
+// Binary columnar order file: a versioned header followed by row groups.
+// Every group stores each column contiguously with its byte length in front,
+// and new orders are appended as a new group without rewriting the ones
+// already on disk. Since version 2 a group also carries its length and a
+// checksum, so a torn or corrupt group is caught before it is decoded.
+// Values are written in host byte order.
+const uint32_t ORDER_COLUMNS_VERSION = 2;
+
+// Columns of a row group, in the order they are stored.
+enum OrderColumn : uint32_t {
+    COL_ID,
+    COL_BUYER,
+    COL_STORE,
+    COL_TOTAL,
+    COL_STATUS,
+    COL_TIMESTAMP,
+    COL_ITEMS,
+    COL_COUNT
+};
+
+struct StringColumn {
+    vector<uint32_t> offsets{0};
+    string bytes;
+
+    size_t size() const { return offsets.size() - 1; }
+    string_view at(size_t i) const {
+        return string_view(bytes).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    void push_back(string_view value) {
+        bytes.append(value);
+        offsets.push_back(static_cast<uint32_t>(bytes.size()));
+    }
+};
+
+struct OrderColumns {
+    uint32_t version = 0;
+    size_t rows = 0;
+    vector<int32_t> id;
+    StringColumn buyer;
+    StringColumn store;
+    vector<double> total;
+    StringColumn status;
+    vector<int64_t> timestamp;
+
+    // Item lines of order i live at [itemOffsets[i], itemOffsets[i + 1]).
+    vector<uint32_t> itemOffsets{0};
+    vector<int32_t> itemId;
+    StringColumn itemName;
+    vector<int32_t> itemQuantity;
+    vector<double> itemPrice;
+};
+
+bool writeOrderColumns(const string& path, const vector<Order>& orders);
+bool appendOrderColumns(const string& path, const vector<Order>& orders);
+
+// Fails, with a warning, on a file whose checksums, lengths or offsets do
+// not add up; nothing read from such a file is kept.
+bool readOrderColumns(const string& path, OrderColumns& out);
+
+// Same, over the file bytes in data and starting at the row group at offset
+// (0 reads the whole file). offset is moved past the last group read.
+bool readOrderColumns(const string& path, string_view data, OrderColumns& out, uint64_t& offset);
+
+void materializeOrders(const OrderColumns& columns, vector<Order>& orders);
+
+#endif // ORDER_COLUMNS_H
@@ -5,18 +5,31 @@
 #include <algorithm>
 #include <ctime>
 #include <iomanip>
-
-#if !defined(_WIN32) && !defined(__APPLE__)
-    #define _XOPEN_SOURCE
-#endif
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <unordered_map>
+#include <iterator>
 
 #include "serialization.h"
+#include "mapped_file.h"
+#include "order_columns.h"
+#include "wal.h"
+#include "snapshot_files.h"
+#include "transaction_journal.h"
+#include "ledger.h"
+#include "civil_time.h"
+#include "csv_codec.h"
 #include "../User/user.h"     
 #include "../User/buyer.h"    
 #include "../User/seller.h"   
+#include "../User/user_directory.h"
 #include "../Bank/bank_customer.h"
 #include "../Item/item.h"
 #include "../Item/order.h"
+#include "../Item/order_index.h"
+#include "../Item/sales_sketch.h"
+#include "../Item/inventory_service.h"
 #include "../User/admin.h"
 #include "../Bank/bank.h"
 
@@ -27,328 +40,892 @@ const string DATA_FOLDER = "data/";
 const string BANK_FILE = DATA_FOLDER + "bank_accounts.csv";
 const string USERS_FILE = DATA_FOLDER + "users.csv";
 const string INVENTORY_FILE = DATA_FOLDER + "inventory.csv";
+const string BANK_DIR = DATA_FOLDER + "accounts";
+const string USERS_DIR = DATA_FOLDER + "users";
+const string INVENTORY_DIR = DATA_FOLDER + "inventory";
 const string ORDERS_FILE = DATA_FOLDER + "orders.csv";
+const string ORDERS_COLUMNAR_FILE = DATA_FOLDER + "orders.col";
 
-extern Bank systemBank;
+const string WAL_FILE = DATA_FOLDER + "wal.log";
+const string WAL_CHECKPOINT_FILE = DATA_FOLDER + "wal.checkpoint";
 
-// Fungsi Helper CSV
-vector<string> split(const string& s, char delimiter) {
-    vector<string> tokens;
-    string token;
-    istringstream tokenStream(s);
-    while (getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
-    }
-    return tokens;
-}
+// Mutations are folded back into the snapshot files every this many records.
+const size_t WAL_CHECKPOINT_INTERVAL = 1024;
 
-string timePointToISOString(const chrono::system_clock::time_point& tp) {
-    time_t timeT = chrono::system_clock::to_time_t(tp);
-    tm* gmtm = gmtime(&timeT); 
-    
-    if (gmtm == nullptr) return "UnknownTime";
+OrderFileFormat orderFileFormat = ORDERS_CSV;
 
-    stringstream ss;
-    ss << put_time(gmtm, "%Y-%m-%d %H:%M:%S"); 
-    return ss.str();
-}
+WriteAheadLog wal(WAL_FILE, WAL_CHECKPOINT_FILE);
 
-chrono::system_clock::time_point parseISOString(const string& isoString) {
-    tm t{}; 
-    istringstream ss(isoString);
-    if (!(ss >> get_time(&t, "%Y-%m-%d %H:%M:%S"))) {
-        return chrono::system_clock::time_point{}; 
-    }
-    
-    time_t tt = static_cast<time_t>(-1);
+// Orders logged since the last checkpoint that the order file does not hold yet.
+vector<Order> pendingOrders;
 
-    #if defined(_WIN32)
-        t.tm_isdst = 0; 
-        time_t local_time = mktime(&t);
+// Segment writes and the marker of a checkpoint still in progress.
+future<void> checkpointTask;
 
-        if (local_time != static_cast<time_t>(-1)) {
-             extern long _timezone;
-             tt = local_time - _timezone;
-        } else {
-             tt = static_cast<time_t>(-1);
-        }
-    #endif
+JournalSettings journalSettings;
+map<string, unique_ptr<TransactionLedger>> transactionLedgers;
+
+extern Bank systemBank;
+extern vector<shared_ptr<User>> users;
 
-    if (tt == static_cast<time_t>(-1)) { 
-        return chrono::system_clock::time_point{};
+// Timestamps in the files are UTC.
+chrono::system_clock::time_point parseISOString(string_view isoString) {
+    int64_t seconds;
+    if (!parseCivilTime(isoString, seconds)) {
+        return chrono::system_clock::time_point{}; 
     }
+    return chrono::system_clock::time_point{chrono::seconds(seconds)};
+}
+
+void BankTransaction::appendCSV(string& out) const {
+    char stamp[CIVIL_TIME_LENGTH];
 
-    return chrono::system_clock::from_time_t(tt);
+    appendNumber(out, accountId);
+    out += ',';
+    if (formatCivilTime(toUnixSeconds(timestamp), stamp)) {
+        out.append(stamp, CIVIL_TIME_LENGTH);
+    } else {
+        out += "UnknownTime";
+    }
+    out += ',';
+    out += type;
+    out += ',';
+    appendFixed(out, amount, 2);
+    out += ',';
+
+    size_t start = out.size();
+    out += description;
+    replace(out.begin() + static_cast<ptrdiff_t>(start), out.end(), ',', ';');
 }
 
 string BankTransaction::toCSV() const {
-    stringstream ss;
-    ss << accountId << ",";
-    ss << timePointToISOString(timestamp) << ",";
-    ss << type << ",";
-    ss << fixed << setprecision(2) << amount << ",";
-    
-    string safeDescription = description;
-    replace(safeDescription.begin(), safeDescription.end(), ',', ';');
-    ss << safeDescription;
-    
-    return ss.str();
+    string out;
+    appendCSV(out);
+    return out;
 }
 
-BankTransaction BankTransaction::fromCSV(const vector<string>& tokens) {
+// A row with a bad number keeps accountId 0, which callers skip.
+BankTransaction BankTransaction::fromCSV(span<const string_view> tokens) {
     BankTransaction t;
+    t.accountId = 0;
+    t.amount = 0.0;
     if (tokens.size() < 5) return t;
     
-    try {
-        t.accountId = stoi(tokens[0]);
-        t.timestamp = parseISOString(tokens[1]);
-        t.type = tokens[2];
-        t.amount = stod(tokens[3]);
-        t.description = tokens[4];
-    } catch (...) {
-    }
+    int accountId;
+    if (!parseNumber(tokens[0], accountId) || !parseNumber(tokens[3], t.amount)) return t;
+
+    t.accountId = accountId;
+    t.timestamp = parseISOString(tokens[1]);
+    t.type = string(tokens[2]);
+    t.description = string(tokens[4]);
     return t;
 }
 
+void setOrderFileFormat(OrderFileFormat format) {
+    orderFileFormat = format;
+}
+
+OrderFileFormat getOrderFileFormat() {
+    return orderFileFormat;
+}
+
 // Deklarasi Fungsi Save
-void saveBankAccounts(const vector<shared_ptr<User>>& users);
-void saveUsers(const vector<shared_ptr<User>>& users);
-void saveInventory(const vector<shared_ptr<User>>& users);
+SegmentWriter snapshotBankAccounts();
+SegmentWriter snapshotUsers();
+SegmentWriter snapshotInventory();
 void saveOrders(const vector<Order>& orders);
-
-// Fungsi Utama Save
-void saveAllData(const vector<shared_ptr<User>>& users, 
+void appendOrders(const vector<Order>& orders);
+void appendPendingOrders();
+uint64_t orderFileBytes();
+void markCheckpoint();
+void finishCheckpoint();
+void reportTransactionJournals();
+
+// Fungsi Utama Save. Users come from the dirty lists, not from the list.
+void saveAllData(const vector<shared_ptr<User>>&, 
                  const vector<Order>& orders) {
-    saveBankAccounts(users);
-    saveUsers(users);
-    saveInventory(users);
-    saveOrders(orders);
+    finishCheckpoint();
+    snapshotBankAccounts().commit();
+    snapshotUsers().commit();
+    snapshotInventory().commit();
+    // The order file is append-only; only a missing one is written in full.
+    if (orderFileBytes() > 0) {
+        appendPendingOrders();
+    } else {
+        saveOrders(orders);
+    }
+    markCheckpoint();
+    flushTransactionJournals();
+    reportTransactionJournals();
     cout << "All data was successfully saved to CSV file.\n\n";
 }
 
-// Menyimpan Account Bank
-void saveBankAccounts(const vector<shared_ptr<User>>& users) {
-    ofstream ofs(BANK_FILE);
-    if (!ofs.is_open()) { return; }
-    
-    for (const auto& user : users) {
-        if (auto account = user->getAccount()) {
-            ofs << account->toCSV() << "\n";
+// Columns that identify a record in the segment files.
+const size_t ACCOUNT_KEY_COLUMN = 1;
+const size_t USER_KEY_COLUMN = 0;
+const size_t STORE_KEY_COLUMN = 0;
+
+// Menyimpan Account Bank (hanya akun yang berubah). Only the records marked
+// dirty are serialized and their flags cleared here; commit() merges them
+// into the segment files.
+SegmentWriter snapshotBankAccounts() {
+    SegmentWriter writer(BANK_DIR, dirtyAccounts.marked(), ACCOUNT_KEY_COLUMN);
+    for (size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+        for (const string& name : dirtyAccounts.in(segment)) {
+            auto user = userDirectory.findByName(name);
+            auto account = user ? user->getAccount() : nullptr;
+            if (!account || !account->isDirty()) continue;
+
+            string row;
+            account->appendCSV(row);
+            row += '\n';
+            writer.replace(segment, name, row);
+            account->clearDirty();
         }
     }
-    ofs.close();
+    dirtyAccounts.clear();
+    return writer;
 }
 
-// Menyimpan User
-void saveUsers(const vector<shared_ptr<User>>& users) {
-    ofstream ofs(USERS_FILE);
-    if (!ofs.is_open()) { return; }
-    
-    for (const auto& user : users) {
-        ofs << user->userToCSV() << "\n"; 
+// Menyimpan User (hanya user yang berubah)
+SegmentWriter snapshotUsers() {
+    SegmentWriter writer(USERS_DIR, dirtyUsers.marked(), USER_KEY_COLUMN);
+    for (size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+        for (const string& name : dirtyUsers.in(segment)) {
+            auto user = userDirectory.findByName(name);
+            if (!user || !user->isDirty()) continue;
+
+            writer.replace(segment, name, user->userToCSV() + "\n");
+            user->clearDirty();
+        }
     }
-    ofs.close();
+    dirtyUsers.clear();
+    return writer;
 }
 
-// Menyimpan Inventory
-void saveInventory(const vector<shared_ptr<User>>& users) {
-    ofstream ofs(INVENTORY_FILE);
-    if (!ofs.is_open()) { return; }
-    
-    for (const auto& user : users) {
-        if (user->getRole() == "Seller") {
-            if (auto seller = dynamic_pointer_cast<Seller>(user)) {
-                ofs << seller->inventoryToCSV(); 
-            }
+// Menyimpan Inventory (hanya toko yang berubah)
+SegmentWriter snapshotInventory() {
+    SegmentWriter writer(INVENTORY_DIR, dirtyStores.marked(), STORE_KEY_COLUMN);
+    for (size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+        for (const string& storeName : dirtyStores.in(segment)) {
+            auto seller = userDirectory.findByStore(storeName);
+            if (!seller || !seller->isInventoryDirty()) continue;
+
+            writer.replace(segment, storeName, seller->inventoryToCSV());
+            seller->clearInventoryDirty();
         }
     }
-    ofs.close();
+    dirtyStores.clear();
+    return writer;
+}
+
+// Rows are serialized into one buffer and written in large blocks.
+void writeOrderRows(ofstream& ofs, const vector<Order>& orders) {
+    const size_t blockBytes = size_t(1) << 20;
+    string buffer;
+    buffer.reserve(blockBytes + 4096);
+
+    for (const auto& order : orders) {
+        order.appendCSV(buffer);
+        buffer += '\n';
+        if (buffer.size() >= blockBytes) {
+            ofs.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    ofs.write(buffer.data(), static_cast<streamsize>(buffer.size()));
 }
 
 // Menyimpan Order
 void saveOrders(const vector<Order>& orders) {
-    ofstream ofs(ORDERS_FILE);
+    if (orderFileFormat == ORDERS_COLUMNAR) {
+        if (!writeOrderColumns(ORDERS_COLUMNAR_FILE + ".tmp", orders)) {
+            cerr << "ERROR: Could not write " << ORDERS_COLUMNAR_FILE << ".\n";
+            return;
+        }
+        commitSnapshot(ORDERS_COLUMNAR_FILE);
+        return;
+    }
+
+    ofstream ofs(ORDERS_FILE + ".tmp", ios::binary);
     if (!ofs.is_open()) { return; }
     
-    for (const auto& order : orders) {
-        ofs << order.toCSV() << "\n";
-    }
+    writeOrderRows(ofs, orders);
     ofs.close();
+    commitSnapshot(ORDERS_FILE);
 }
 
-void saveTransaction(const BankTransaction& t, const string& filename) {
-    ofstream file(filename, ios::app); 
-    if (file.is_open()) {
-        file << t.toCSV() << "\n"; 
-        file.close();
-    } else {
-        cerr << "ERROR: Could not open " << filename << " for saving transaction.\n";
+// Menambah Order ke file tanpa menulis ulang seluruh riwayat
+void appendOrders(const vector<Order>& orders) {
+    if (orders.empty()) return;
+
+    if (orderFileFormat == ORDERS_COLUMNAR) {
+        if (!appendOrderColumns(ORDERS_COLUMNAR_FILE, orders)) {
+            cerr << "Error: Could not open " << ORDERS_COLUMNAR_FILE << " for writing. Order recording failed.\n";
+        }
+        return;
+    }
+
+    ofstream file(ORDERS_FILE, ios::app | ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error: Could not open " << ORDERS_FILE << " for writing. Order recording failed.\n";
+        return;
+    }
+    writeOrderRows(file, orders);
+}
+
+uint64_t orderFileBytes() {
+    const string& path = (orderFileFormat == ORDERS_COLUMNAR) ? ORDERS_COLUMNAR_FILE : ORDERS_FILE;
+    error_code ec;
+    uint64_t bytes = filesystem::file_size(path, ec);
+    return ec ? 0 : bytes;
+}
+
+// Write-ahead log //
+WalCheckpoint orderFileMarker() {
+    WalCheckpoint marker;
+    marker.ordersFormat = orderFileFormat;
+    marker.ordersBytes = orderFileBytes();
+    return marker;
+}
+
+void markCheckpoint() {
+    pendingOrders.clear();
+    wal.checkpoint(orderFileMarker(), wal.position());
+}
+
+void finishCheckpoint() {
+    if (checkpointTask.valid()) checkpointTask.get();
+}
+
+// Folds the log into the snapshots without holding up the mutation that
+// made it due. Here the dirty rows are copied and the new orders appended;
+// the segment files, the marker and the log cut are written in the
+// background, while later mutations log past the captured position.
+void checkpointLog() {
+    if (checkpointTask.valid() && checkpointTask.wait_for(chrono::seconds(0)) != future_status::ready) return;
+    finishCheckpoint();
+
+    vector<SegmentWriter> writers;
+    writers.push_back(snapshotBankAccounts());
+    writers.push_back(snapshotUsers());
+    writers.push_back(snapshotInventory());
+    appendPendingOrders();
+
+    WalCheckpoint marker = orderFileMarker();
+    WalPosition at = wal.position();
+    checkpointTask = async(launch::async, [writers = move(writers), marker, at]() mutable {
+        for (auto& writer : writers) writer.commit();
+        wal.checkpoint(marker, at);
+    });
+}
+
+void logMutation(WalRecordType type, const string& payload) {
+    wal.append(type, payload);
+    if (wal.pendingRecords() >= WAL_CHECKPOINT_INTERVAL) {
+        checkpointLog();
+    }
+}
+
+void logBalance(int accountId, double balance) {
+    string payload;
+    appendNumber(payload, accountId);
+    payload += ',';
+    appendNumber(payload, balance);
+    logMutation(WAL_BALANCE_SET, payload);
+}
+
+void logStock(const string& storeName, int itemId, int quantity) {
+    string payload = storeName;
+    payload += ',';
+    appendNumber(payload, itemId);
+    payload += ',';
+    appendNumber(payload, quantity);
+    logMutation(WAL_STOCK_SET, payload);
+}
+
+void logOrderInsert(const Order& order) {
+    pendingOrders.push_back(order);
+    logMutation(WAL_ORDER_INSERT, order.toCSV());
+}
+
+void logUserUpsert(const User& user) {
+    string payload = user.userToCSV() + "\n";
+    if (auto account = user.getAccount()) {
+        account->appendCSV(payload);
+    }
+    logMutation(WAL_USER_UPSERT, payload);
+}
+
+// Transaction ledger //
+TransactionLedger& ledgerFor(const string& filename) {
+    auto& ledger = transactionLedgers[filename];
+    if (!ledger) {
+        ledger = make_unique<TransactionLedger>(filename, journalSettings);
+    }
+    return *ledger;
+}
+
+void setJournalSettings(const JournalSettings& settings) {
+    journalSettings = settings;
+}
+
+void flushTransactionJournals() {
+    for (auto& entry : transactionLedgers) {
+        entry.second->flush();
+    }
+}
+
+void reportTransactionJournals() {
+    for (auto& entry : transactionLedgers) {
+        JournalStats stats = entry.second->stats();
+        if (stats.records == 0) continue;
+
+        double perSecond = stats.elapsedSeconds > 0 ? stats.records / stats.elapsedSeconds : 0.0;
+        cout << fixed << setprecision(1)
+             << "Journal " << entry.first << ": " << stats.records << " writes in "
+             << stats.groups << " group commits, " << perSecond << " writes/sec, append "
+             << stats.appendMicros / stats.records << " us avg / " << stats.maxAppendMicros
+             << " us max, commit " << (stats.groups ? stats.commitMicros / stats.groups : 0.0)
+             << " us avg per group\n";
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
     }
 }
 
+void saveTransaction(const BankTransaction& t, const string& filename) {
+    ledgerFor(filename).append(t);
+}
+
+// Hasil parsing tiap file sebelum digabung (join) dengan file lainnya.
+// Parsing tidak menyentuh state global, sehingga bisa berjalan paralel.
+struct UserRow {
+    string name;
+    string password;
+    string role;
+    string storeName;
+};
+
+struct InventoryRow {
+    string storeName;
+    Item item;
+};
+
+template <typename Row>
+struct ParsedFile {
+    vector<Row> rows;
+    bool found = false;
+    bool migrated = false;
+    double millis = 0.0;
+};
+
+// Files below this size are parsed by a single thread.
+const size_t PARALLEL_PARSE_MIN_BYTES = size_t(4) << 20;
+
+using LoadClock = chrono::steady_clock;
+
+double millisSince(LoadClock::time_point start) {
+    return chrono::duration<double, milli>(LoadClock::now() - start).count();
+}
+
 // Deklarasi Fungsi Load Internal
-map<string, shared_ptr<BankCustomer>> loadBankAccounts();
-void loadUsers(vector<shared_ptr<User>>& users, 
-               const map<string, shared_ptr<BankCustomer>>& bankMap);
-void loadInventory(vector<shared_ptr<User>>& users);
+ParsedFile<shared_ptr<BankCustomer>> parseBankAccounts();
+ParsedFile<UserRow> parseUsers();
+ParsedFile<InventoryRow> parseInventory();
 void loadOrders(vector<Order>& orders);
+size_t loadOrderFile(vector<Order>& orders);
+void trimOrderFile(const WalCheckpoint& marker);
+shared_ptr<User> makeUser(const UserRow& row, shared_ptr<BankCustomer> account);
+void replayLog(const vector<WalRecord>& records, vector<Order>& orders);
 
 
 // Fungsi Load Utama
+// Keempat file di-parse bersamaan (orders.csv yang besar juga dipecah per
+// potongan baris), lalu hasilnya digabung: akun ke user, item ke seller.
 void loadAllData(vector<shared_ptr<User>>& users, 
                  vector<Order>& orders) {
+    auto loadStart = LoadClock::now();
     
-    users.clear();
+    userDirectory.clear();
     orders.clear();
+    orderIndex.truncate(0);
+    salesSketches.truncate(0);
+    pendingOrders.clear();
+    dirtyAccounts.clear();
+    dirtyUsers.clear();
+    dirtyStores.clear();
+
+    WalCheckpoint marker;
+    vector<WalRecord> records = wal.recover(marker);
+    trimOrderFile(marker);
+
+    double ordersMillis = 0.0;
+    auto accountsTask = async(launch::async, parseBankAccounts);
+    auto usersTask = async(launch::async, parseUsers);
+    auto inventoryTask = async(launch::async, parseInventory);
+    double ledgerMillis = 0.0;
+    auto ledgerTask = async(launch::async, [&ledgerMillis] {
+        auto start = LoadClock::now();
+        vector<BankTransaction> rows = BankTransaction::loadFromFile(TRANSACTIONS_FILE);
+        ledgerMillis = millisSince(start);
+        return rows;
+    });
+    auto ordersTask = async(launch::async, [&orders, &ordersMillis] {
+        auto start = LoadClock::now();
+        loadOrderFile(orders);
+        ordersMillis = millisSince(start);
+    });
+
+    auto accounts = accountsTask.get();
+    auto userRows = usersTask.get();
+    auto inventory = inventoryTask.get();
+    auto ledgerRows = ledgerTask.get();
+    ordersTask.get();
+
+    auto joinStart = LoadClock::now();
+
+    if (!accounts.found) { cout << "bank_accounts.csv not found/empty.\n"; }
+    if (!userRows.found) { cout << "users.csv not found/empty.\n"; }
+    if (!inventory.found) { cout << "inventory.csv not found/empty.\n"; }
+
+    // Account rows stay dirty when read from a legacy file, so the next
+    // save writes them into the segmented layout.
+    unordered_map<string, shared_ptr<BankCustomer>> bankMap;
+    for (const auto& account : accounts.rows) {
+        if (!accounts.migrated) account->clearDirty();
+        bankMap[account->getName()] = account;
+    }
+
+    userDirectory.reserve(userRows.rows.size());
+    systemBank.reserveAccounts(userRows.rows.size());
+    for (const auto& row : userRows.rows) {
+        shared_ptr<BankCustomer> account = nullptr;
+        auto linked = bankMap.find(row.name);
+        if (linked != bankMap.end()) {
+            account = linked->second;
+        }
+
+        shared_ptr<User> newUser = makeUser(row, account);
+        if (!newUser) continue;
+
+        if (!userRows.migrated) newUser->clearDirty();
+        userDirectory.put(newUser);
+        if (account && !systemBank.registerCustomer(account)) {
+            cerr << "Warning: Bank account ID " << account->getId() << " of " << row.name
+                 << " is already in use; it is not registered with the bank.\n";
+        }
+    }
 
-    auto bankMap = loadBankAccounts(); 
+    for (const auto& row : inventory.rows) {
+        if (auto seller = userDirectory.findByStore(row.storeName)) {
+            seller->addItemObject(row.item);
+        }
+    }
+    if (!inventory.migrated) {
+        for (const auto& user : users) {
+            if (auto seller = dynamic_pointer_cast<Seller>(user)) {
+                seller->clearInventoryDirty();
+            }
+        }
+        dirtyStores.clear();
+    }
 
-    loadUsers(users, bankMap);
+    orders.insert(orders.end(), pendingOrders.begin(), pendingOrders.end());
+    double joinMillis = millisSince(joinStart);
 
-    loadInventory(users);
+    auto replayStart = LoadClock::now();
+    replayLog(records, orders);
+    double replayMillis = millisSince(replayStart);
 
-    loadOrders(orders);
+    // After the replay, so the accounts it registers also get their last
+    // activity from the ledger.
+    auto ledgerJoinStart = LoadClock::now();
+    systemBank.restoreTransactions(ledgerRows);
+    joinMillis += millisSince(ledgerJoinStart);
     
-    cout << "All data was loaded successfully.\n\n";
+    cout << "All data was loaded successfully.\n";
+    cout << fixed << setprecision(1)
+         << "Load time: " << millisSince(loadStart) << " ms"
+         << " (parallel parse: accounts " << accounts.millis
+         << " ms, users " << userRows.millis
+         << " ms, inventory " << inventory.millis
+         << " ms, orders " << ordersMillis
+         << " ms, ledger " << ledgerMillis
+         << " ms; join " << joinMillis
+         << " ms; log replay " << replayMillis << " ms)\n\n";
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
 }
 
-// Memuat Bank Account
-map<string, shared_ptr<BankCustomer>> loadBankAccounts() {
-    map<string, shared_ptr<BankCustomer>> bankMap;
-    ifstream ifs(BANK_FILE);
-    if (!ifs.is_open()) { cout << "bank_accounts.csv not found/empty.\n"; return bankMap; }
-
-    string line;
-    while (getline(ifs, line)) {
-        if (line.empty()) continue;
-        auto tokens = split(line, ',');
-        auto account = BankCustomer::fromCSV(tokens); 
-        if (account) {
-            bankMap[account->getName()] = account;
-        }
+// Cuts off orders appended by a checkpoint that crashed before it was marked
+// complete; the log still holds them and replays them.
+void trimOrderFile(const WalCheckpoint& marker) {
+    if (marker.ordersFormat != orderFileFormat) return;
+    if (orderFileBytes() <= marker.ordersBytes) return;
+
+    const string& path = (orderFileFormat == ORDERS_COLUMNAR) ? ORDERS_COLUMNAR_FILE : ORDERS_FILE;
+    error_code ec;
+    filesystem::resize_file(path, marker.ordersBytes, ec);
+}
+
+UserRow userRowFromCSV(span<const string_view> tokens) {
+    UserRow row;
+    row.name = string(tokens[0]);
+    row.password = string(tokens[1]);
+    row.role = string(tokens[2]);
+    row.storeName = (tokens.size() > 3) ? string(tokens[3]) : "";
+    return row;
+}
+
+// Membuat User dari satu baris users.csv
+shared_ptr<User> makeUser(const UserRow& row, shared_ptr<BankCustomer> account) {
+    if (row.role == "Buyer") {
+        return make_shared<Buyer>(row.name, row.password, account);
+    } else if (row.role == "Seller") {
+        return make_shared<Seller>(row.name, row.password, row.storeName, account); 
+    } else if (row.role == "Admin") {
+        return make_shared<Admin>(row.name, row.password);
     }
-    ifs.close();
-    return bankMap;
+    return nullptr;
 }
 
-// Memuat User
-void loadUsers(vector<shared_ptr<User>>& users, 
-               const map<string, shared_ptr<BankCustomer>>& bankMap) {
-    ifstream ifs(USERS_FILE);
-    if (!ifs.is_open()) { cout << "users.csv not found/empty.\n"; return; }
-
-    string line;
-    while (getline(ifs, line)) {
-        if (line.empty()) continue;
-        auto tokens = split(line, ',');
-        if (tokens.size() < 3) continue; 
-
-        string name = tokens[0];
-        string password = tokens[1];
-        string role = tokens[2];
-        string storeName = (tokens.size() > 3) ? tokens[3] : "";
-
-        shared_ptr<User> newUser = nullptr;
-        shared_ptr<BankCustomer> account = nullptr;
-        if (bankMap.count(name)) {
-            account = bankMap.at(name);
+void replayUserUpsert(string_view payload) {
+    size_t split = payload.find('\n');
+    string_view userLine = payload.substr(0, split);
+    string_view accountLine = (split == string_view::npos) ? string_view() : payload.substr(split + 1);
+
+    vector<string_view> tokens;
+    shared_ptr<BankCustomer> account = nullptr;
+    splitView(accountLine, ',', tokens);
+    if (auto logged = BankCustomer::fromCSV(tokens)) {
+        account = systemBank.findAccount(logged->getId());
+        if (!account) {
+            account = logged;
+            systemBank.registerCustomer(account);
         }
+    }
 
-        if (role == "Buyer") {
-            newUser = make_shared<Buyer>(name, password, account);
-        } else if (role == "Seller") {
-            newUser = make_shared<Seller>(name, password, storeName, account); 
-        } else if (role == "Admin") {
-            newUser = make_shared<Admin>(name, password);
-        }
-        
-        if(newUser) {
-            users.push_back(newUser);
+    splitView(userLine, ',', tokens);
+    if (tokens.size() < 3) return;
+    auto user = makeUser(userRowFromCSV(tokens), account);
+    if (!user) return;
 
-            if (account) {
-                systemBank.registerCustomer(account); 
+    userDirectory.put(user);
+}
+
+// Applies the records logged after the last checkpoint, in order.
+void replayLog(const vector<WalRecord>& records, vector<Order>& orders) {
+    vector<string_view> tokens;
+    for (const auto& record : records) {
+        switch (record.type) {
+            case WAL_BALANCE_SET:
+            case WAL_BALANCE_DELTA: {
+                splitView(record.payload, ',', tokens);
+                int accountId;
+                double value;
+                if (tokens.size() < 2 || !parseNumber(tokens[0], accountId) || !parseNumber(tokens[1], value)) break;
+                if (auto account = systemBank.findAccount(accountId)) {
+                    if (record.type == WAL_BALANCE_DELTA) value += account->getBalance();
+                    account->setBalance(value);
+                }
+                break;
+            }
+            case WAL_STOCK_SET:
+            case WAL_STOCK_DELTA: {
+                splitView(record.payload, ',', tokens);
+                int itemId, value;
+                if (tokens.size() < 3 || !parseNumber(tokens[1], itemId) || !parseNumber(tokens[2], value)) break;
+                if (record.type == WAL_STOCK_DELTA) {
+                    inventoryService.adjustQuantity(string(tokens[0]), itemId, value);
+                } else {
+                    inventoryService.setQuantity(string(tokens[0]), itemId, value);
+                }
+                break;
             }
+            case WAL_ORDER_INSERT: {
+                splitView(record.payload, ',', tokens);
+                auto order = Order::fromCSV(tokens);
+                if (!order) break;
+                orders.push_back(*order);
+                pendingOrders.push_back(*order);
+                break;
+            }
+            case WAL_USER_UPSERT:
+                replayUserUpsert(record.payload);
+                break;
         }
     }
-    ifs.close();
+}
+
+// Memuat Bank Account
+ParsedFile<shared_ptr<BankCustomer>> parseBankAccounts() {
+    auto start = LoadClock::now();
+    ParsedFile<shared_ptr<BankCustomer>> parsed;
+    vector<string_view> tokens;
+
+    parsed.found = forEachSnapshotFile(BANK_DIR, BANK_FILE, [&](MappedFile& file) {
+        file.forEachLine([&](string_view line) {
+            splitView(line, ',', tokens);
+            auto account = BankCustomer::fromCSV(tokens); 
+            if (account) {
+                parsed.rows.push_back(account);
+            }
+        });
+    }, parsed.migrated);
+    parsed.millis = millisSince(start);
+    return parsed;
+}
+
+// Memuat User
+ParsedFile<UserRow> parseUsers() {
+    auto start = LoadClock::now();
+    ParsedFile<UserRow> parsed;
+    vector<string_view> tokens;
+
+    parsed.found = forEachSnapshotFile(USERS_DIR, USERS_FILE, [&](MappedFile& file) {
+        file.forEachLine([&](string_view line) {
+            splitView(line, ',', tokens);
+            if (tokens.size() < 3) return; 
+            parsed.rows.push_back(userRowFromCSV(tokens));
+        });
+    }, parsed.migrated);
+    parsed.millis = millisSince(start);
+    return parsed;
 }
 
 // Memuat Inventory
-void loadInventory(vector<shared_ptr<User>>& users) {
-    ifstream ifs(INVENTORY_FILE);
-    if (!ifs.is_open()) { cout << "inventory.csv not found/empty.\n"; return; }
-
-    map<string, shared_ptr<Seller>> sellerMap;
-    for (const auto& user : users) {
-        if (auto seller = dynamic_pointer_cast<Seller>(user)) {
-            sellerMap[seller->getStoreName()] = seller;
+ParsedFile<InventoryRow> parseInventory() {
+    auto start = LoadClock::now();
+    ParsedFile<InventoryRow> parsed;
+    vector<string_view> tokens;
+
+    parsed.found = forEachSnapshotFile(INVENTORY_DIR, INVENTORY_FILE, [&](MappedFile& file) {
+        file.forEachLine([&](string_view line) {
+            splitView(line, ',', tokens);
+            if (tokens.size() < 5) return; 
+
+            auto item = Item::fromCSV(span<const string_view>(tokens).subspan(1, 4)); 
+            if (item) {
+                parsed.rows.push_back({string(tokens[0]), *item});
+            }
+        });
+    }, parsed.migrated);
+    parsed.millis = millisSince(start);
+    return parsed;
+}
+
+// Orders
+// How far the order file has been read into the orders list: the file it
+// was, the bytes consumed and how many rows they gave. Orders after those
+// rows in the list are pendingOrders.
+struct OrderFileCursor {
+    bool valid = false;
+    OrderFileFormat format = ORDERS_CSV;
+    FileIdentity identity;
+    uint64_t bytes = 0;
+    size_t rows = 0;
+    // Last bytes consumed, compared again to notice an in-place rewrite.
+    string tail;
+};
+
+const size_t ORDER_CURSOR_TAIL_BYTES = 64;
+
+OrderFileCursor orderCursor;
+
+void rememberOrderFile(const MappedFile& file, uint64_t bytes, size_t rows) {
+    size_t tailBytes = static_cast<size_t>(min<uint64_t>(bytes, ORDER_CURSOR_TAIL_BYTES));
+
+    orderCursor.valid = true;
+    orderCursor.format = orderFileFormat;
+    orderCursor.identity = file.identity();
+    orderCursor.bytes = bytes;
+    orderCursor.rows = rows;
+    orderCursor.tail = string(file.view().substr(static_cast<size_t>(bytes) - tailBytes, tailBytes));
+}
+
+// The pending orders are already the rows after the cursor in the orders
+// list, so once they are appended the cursor moves past them rather than
+// the file being read again on the next load.
+void appendPendingOrders() {
+    uint64_t before = orderFileBytes();
+    appendOrders(pendingOrders);
+
+    const string& path = (orderFileFormat == ORDERS_COLUMNAR) ? ORDERS_COLUMNAR_FILE : ORDERS_FILE;
+    MappedFile file(path);
+    bool moved = orderCursor.valid && orderCursor.format == orderFileFormat &&
+                 orderCursor.bytes == before && file.isOpen() && file.view().size() > before &&
+                 file.identity() == orderCursor.identity;
+    if (moved) rememberOrderFile(file, file.view().size(), orderCursor.rows + pendingOrders.size());
+    pendingOrders.clear();
+}
+
+// True when file is the one read last time, grown or unchanged.
+bool continuesOrderFile(const MappedFile& file, const vector<Order>& orders) {
+    if (!orderCursor.valid || orderCursor.format != orderFileFormat) return false;
+    if (!(file.identity() == orderCursor.identity)) return false;
+    if (file.view().size() < orderCursor.bytes || orders.size() < orderCursor.rows) return false;
+
+    size_t tailStart = static_cast<size_t>(orderCursor.bytes) - orderCursor.tail.size();
+    return file.view().substr(tailStart, orderCursor.tail.size()) == orderCursor.tail;
+}
+
+uint64_t parseOrdersCSV(MappedFile& file, uint64_t begin, vector<Order>& orders);
+void loadOrdersCSV(vector<Order>& orders);
+
+// Brings orders up to date with the order file and returns how many of
+// them are its rows. Only rows appended since the last read are parsed; a
+// file that was truncated or replaced is read again. The orders after the
+// file's rows are only dropped when the file grew.
+size_t loadOrderFile(vector<Order>& orders) {
+    const string& path = (orderFileFormat == ORDERS_COLUMNAR) ? ORDERS_COLUMNAR_FILE : ORDERS_FILE;
+    MappedFile file(path);
+
+    if (file.isOpen() && continuesOrderFile(file, orders)) {
+        if (file.view().size() == orderCursor.bytes) return orderCursor.rows;
+        orders.erase(orders.begin() + static_cast<ptrdiff_t>(orderCursor.rows), orders.end());
+        orderIndex.truncate(orders.size());
+        salesSketches.truncate(orders.size());
+    } else {
+        orderCursor = OrderFileCursor{};
+        orders.clear();
+        orderIndex.truncate(0);
+        salesSketches.truncate(0);
+    }
+
+    if (orderFileFormat == ORDERS_CSV) {
+        if (!file.isOpen()) {
+            cerr << "Warning: Could not open " << ORDERS_FILE << " for reading. Orders list is empty.\n";
+            return orders.size();
         }
+        uint64_t bytes = parseOrdersCSV(file, orderCursor.bytes, orders);
+        rememberOrderFile(file, bytes, orders.size());
+        return orders.size();
     }
-    
-    string line;
-    while (getline(ifs, line)) {
-        if (line.empty()) continue;
-        auto tokens = split(line, ',');
-        if (tokens.size() < 5) continue; 
 
-        string storeName = tokens[0];
-        
-        vector<string> itemTokens(tokens.begin() + 1, tokens.begin() + 5);
-        auto item = Item::fromCSV(itemTokens); 
+    if (!file.isOpen()) {
+        // First run with the columnar format: seed it from the CSV history.
+        loadOrdersCSV(orders);
+        writeOrderColumns(ORDERS_COLUMNAR_FILE, orders);
+        return orders.size();
+    }
 
-        if (item && sellerMap.count(storeName)) {
-            sellerMap.at(storeName)->addItemObject(*item);
+    OrderColumns columns;
+    uint64_t bytes = orderCursor.bytes;
+    if (readOrderColumns(ORDERS_COLUMNAR_FILE, file.view(), columns, bytes)) {
+        materializeOrders(columns, orders);
+        if (columns.version == ORDER_COLUMNS_VERSION) {
+            rememberOrderFile(file, bytes, orders.size());
+            return orders.size();
         }
+        // An older file is rewritten once, so appends add checksummed groups.
+        saveOrders(orders);
+        MappedFile rewritten(ORDERS_COLUMNAR_FILE);
+        if (rewritten.isOpen()) rememberOrderFile(rewritten, rewritten.view().size(), orders.size());
+        return orders.size();
     }
-    ifs.close();
-}
 
-// Orders
-void loadOrders(vector<Order>& orders) {
+    cerr << "Warning: Falling back to " << ORDERS_FILE << ".\n";
+    orderCursor = OrderFileCursor{};
     orders.clear();
+    orderIndex.truncate(0);
+    salesSketches.truncate(0);
+    loadOrdersCSV(orders);
+    return orders.size();
+}
 
-    ifstream file(ORDERS_FILE); 
-
-    if (!file.is_open()) {
-        cerr << "Warning: Could not open " << ORDERS_FILE << " for reading. Orders list is empty.\n";
-        return;
+void loadOrders(vector<Order>& orders) {
+    size_t fileRows = loadOrderFile(orders);
+    // Orders still only in the write-ahead log. Those already in the list
+    // stay, so the index and sketches built over them are kept.
+    size_t held = orders.size() - fileRows;
+    if (held > pendingOrders.size()) {
+        orders.erase(orders.begin() + static_cast<ptrdiff_t>(fileRows), orders.end());
+        orderIndex.truncate(orders.size());
+        salesSketches.truncate(orders.size());
+        held = 0;
     }
+    orders.insert(orders.end(), pendingOrders.begin() + static_cast<ptrdiff_t>(held), pendingOrders.end());
+}
 
-    string line;
-    while (getline(file, line)) {
-        if (line.empty()) continue;
+// Names are interned into local without the table lock; the caller
+// publishes them and remaps the orders.
+void parseOrderRange(MappedFile& file, size_t begin, size_t end, vector<Order>& orders, LocalSymbols& local) {
+    vector<string_view> tokens;
+    file.forEachLine([&](string_view line) {
+        splitView(line, ',', tokens);
         
-        vector<string> tokens = split(line, ',');
-        
-        if (!tokens.empty()) {
-            orders.push_back(Order::fromCSV(tokens)); 
+        if (auto order = Order::fromCSV(tokens, &local)) {
+            orders.push_back(move(*order)); 
         }
-    }
-    file.close();
+    }, begin, end);
 }
 
-std::vector<BankTransaction> BankTransaction::loadFromFile(const std::string& filename) {
-    std::vector<BankTransaction> transactions;
-    std::ifstream file(filename);
-    std::string line;
+void publishOrderSymbols(const LocalSymbols& local, vector<Order>& orders, size_t first) {
+    vector<Symbol> global = local.publish(symbols);
+    for (size_t i = first; i < orders.size(); ++i) orders[i].remapSymbols(global);
+}
 
-    if (!file.is_open()) {
-        return transactions;
+// Parses the rows from begin to the end of the file and returns the bytes
+// consumed. A large range is cut into newline-aligned parts, one per hardware
+// thread, and the parts are concatenated in file order.
+uint64_t parseOrdersCSV(MappedFile& file, uint64_t begin, vector<Order>& orders) {
+    size_t from = static_cast<size_t>(begin);
+    size_t size = file.view().size();
+
+    size_t workers = 1;
+    if (size - from >= PARALLEL_PARSE_MIN_BYTES) {
+        workers = max(1u, thread::hardware_concurrency());
+    }
+    if (workers == 1) {
+        LocalSymbols local;
+        size_t first = orders.size();
+        parseOrderRange(file, from, size, orders, local);
+        publishOrderSymbols(local, orders, first);
+        return size;
     }
 
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    vector<size_t> bounds = file.lineAlignedBounds(workers, from);
+    vector<vector<Order>> parts(bounds.size() - 1);
+    vector<LocalSymbols> tables(parts.size());
+    vector<future<void>> tasks;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        tasks.push_back(async(launch::async, [&file, &bounds, &parts, &tables, i] {
+            parseOrderRange(file, bounds[i], bounds[i + 1], parts[i], tables[i]);
+        }));
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
 
-        std::vector<std::string> tokens = split(line, ',');
-        
-        if (tokens.size() >= 5) {
-            BankTransaction t = BankTransaction::fromCSV(tokens);
-            if (t.accountId > 0) {
-                 transactions.push_back(t);
-            }
-        }
+    // Parts are published in file order, so the ids do not depend on which
+    // thread finished first.
+    size_t total = orders.size();
+    for (const auto& part : parts) total += part.size();
+    orders.reserve(total);
+    for (size_t i = 0; i < parts.size(); ++i) {
+        publishOrderSymbols(tables[i], parts[i], 0);
+        move(parts[i].begin(), parts[i].end(), back_inserter(orders));
     }
+    return size;
+}
+
+void loadOrdersCSV(vector<Order>& orders) {
+    MappedFile file(ORDERS_FILE); 
 
-    file.close();
-    return transactions;
-}
\ No newline at end of file
+    if (!file.isOpen()) {
+        cerr << "Warning: Could not open " << ORDERS_FILE << " for reading. Orders list is empty.\n";
+        return;
+    }
+    parseOrdersCSV(file, 0, orders);
+}
+
+std::vector<BankTransaction> BankTransaction::loadFromFile(const std::string& filename) {
+    return ledgerFor(filename).load(INT64_MIN, INT64_MAX, 0);
+}
+
+std::vector<BankTransaction> BankTransaction::loadFromFile(const std::string& filename,
+                                                           std::chrono::system_clock::time_point from,
+                                                           std::chrono::system_clock::time_point to,
+                                                           int accountId) {
+    return ledgerFor(filename).load(toUnixSeconds(from), toUnixSeconds(to), accountId);
+}
@@ -6,6 +6,7 @@
 #include <string>
 
 #include "bank_transaction.h"
+#include "transaction_journal.h"
 
 using namespace std;
 
@@ -20,4 +21,25 @@ void loadAllData(vector<shared_ptr<User>>& users,
 
 void saveTransaction(const BankTransaction& t, const string& filename);
 
+// Transaction files are written through a TransactionJournal per file. The
+// settings apply to journals opened after the call.
+void setJournalSettings(const JournalSettings& settings);
+void flushTransactionJournals();
+
+// On-disk format of the order history. CSV stays the default; the columnar
+// file (data/orders.col) is read and written instead when selected.
+enum OrderFileFormat { ORDERS_CSV, ORDERS_COLUMNAR };
+
+void setOrderFileFormat(OrderFileFormat format);
+OrderFileFormat getOrderFileFormat();
+
+// Write-ahead log of single mutations. Each call appends one record in O(1)
+// and returns once it is on disk; the snapshot files catch up at the next
+// checkpoint or in saveAllData. Balance and stock are logged as their new
+// values, so a record replayed over a snapshot that has it is harmless.
+void logBalance(int accountId, double balance);
+void logStock(const string& storeName, int itemId, int quantity);
+void logOrderInsert(const Order& order);
+void logUserUpsert(const User& user);
+
 #endif // SERIALIZATION_H
\ No newline at end of file
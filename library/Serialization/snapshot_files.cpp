@@ -0,0 +1,146 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+#include "snapshot_files.h"
+
+using namespace std;
+
+namespace {
+
+const string MANIFEST_NAME = "MANIFEST";
+
+string segmentPath(const string& dir, size_t segment) {
+    char name[16];
+    snprintf(name, sizeof(name), "seg-%02zx.csv", segment);
+    return dir + "/" + name;
+}
+
+string_view csvColumn(string_view line, size_t column) {
+    for (size_t i = 0; i < column; ++i) {
+        size_t comma = line.find(',');
+        if (comma == string_view::npos) return string_view();
+        line.remove_prefix(comma + 1);
+    }
+    return line.substr(0, line.find(','));
+}
+
+} // namespace
+
+DirtyKeys dirtyAccounts;
+DirtyKeys dirtyUsers;
+DirtyKeys dirtyStores;
+
+size_t segmentOf(string_view key) {
+    uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash % SEGMENT_COUNT;
+}
+
+void commitSnapshot(const string& path) {
+    error_code ec;
+    filesystem::rename(path + ".tmp", path, ec);
+    if (ec) {
+        cerr << "ERROR: Could not replace " << path << ": " << ec.message() << "\n";
+    }
+}
+
+bool forEachSnapshotFile(const string& dir, const string& legacyPath,
+                         const function<void(MappedFile&)>& fn, bool& migrated) {
+    migrated = false;
+    if (filesystem::exists(dir + "/" + MANIFEST_NAME)) {
+        for (size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+            MappedFile file(segmentPath(dir, segment));
+            if (file.isOpen()) fn(file);
+        }
+        return true;
+    }
+
+    MappedFile file(legacyPath);
+    if (!file.isOpen()) return false;
+    migrated = true;
+    fn(file);
+    return true;
+}
+
+DirtyKeys::DirtyKeys() : keys(SEGMENT_COUNT) {}
+
+void DirtyKeys::mark(const string& key) {
+    size_t segment = segmentOf(key);
+    keys[segment].push_back(key);
+    segments.set(segment);
+}
+
+void DirtyKeys::clear() {
+    for (size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+        if (segments.test(segment)) keys[segment].clear();
+    }
+    segments.reset();
+}
+
+SegmentWriter::SegmentWriter(const string& dir, const SegmentSet& dirty, size_t keyColumn)
+    : dir(dir), dirty(dirty), keyColumn(keyColumn), contents(SEGMENT_COUNT) {}
+
+void SegmentWriter::replace(size_t segment, const string& key, const string& rows) {
+    SegmentRows& target = contents[segment];
+    auto [slot, added] = target.byKey.try_emplace(key, target.rows.size());
+    if (added) {
+        target.rows.emplace_back(key, rows);
+    } else {
+        target.rows[slot->second].second = rows;
+    }
+}
+
+void SegmentWriter::commit() {
+    if (dirty.none()) return;
+
+    error_code ec;
+    filesystem::create_directories(dir, ec);
+
+    for (size_t segment = 0; segment < SEGMENT_COUNT; ++segment) {
+        if (!dirty.test(segment)) continue;
+
+        string path = segmentPath(dir, segment);
+        const SegmentRows& changed = contents[segment];
+        vector<bool> written(changed.rows.size(), false);
+        string merged;
+        {
+            MappedFile old(path);
+            if (old.isOpen()) {
+                merged.reserve(old.view().size());
+                old.forEachLine([&](string_view line) {
+                    auto found = changed.byKey.find(string(csvColumn(line, keyColumn)));
+                    if (found == changed.byKey.end()) {
+                        merged.append(line);
+                        merged += '\n';
+                    } else if (!written[found->second]) {
+                        merged += changed.rows[found->second].second;
+                        written[found->second] = true;
+                    }
+                });
+            }
+        }
+        for (size_t i = 0; i < changed.rows.size(); ++i) {
+            if (!written[i]) merged += changed.rows[i].second;
+        }
+
+        ofstream ofs(path + ".tmp", ios::trunc);
+        if (!ofs.is_open()) {
+            cerr << "ERROR: Could not write " << path << ".\n";
+            continue;
+        }
+        ofs << merged;
+        ofs.close();
+        commitSnapshot(path);
+    }
+
+    string manifest = dir + "/" + MANIFEST_NAME;
+    if (!filesystem::exists(manifest)) {
+        ofstream ofs(manifest);
+        ofs << "segments " << SEGMENT_COUNT << "\n";
+    }
+}
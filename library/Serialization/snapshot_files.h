@@ -0,0 +1,84 @@
+#ifndef SNAPSHOT_FILES_H
+#define SNAPSHOT_FILES_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bitset>
+#include <functional>
+#include <unordered_map>
+
+#include "mapped_file.h"
+
+using namespace std;
+
+// Users, accounts and inventory are stored as SEGMENT_COUNT files per kind
+// (data/<kind>/seg-NN.csv), each record placed by a hash of its key. A save
+// only rewrites the segments that hold a dirty record, so shutdown cost
+// follows the session's writes rather than the size of the population.
+const size_t SEGMENT_COUNT = 64;
+
+using SegmentSet = bitset<SEGMENT_COUNT>;
+
+size_t segmentOf(string_view key);
+
+// Renames path + ".tmp" over path, so a crash mid-save never leaves a
+// half-written snapshot behind.
+void commitSnapshot(const string& path);
+
+// Calls fn for every segment of dir once its manifest exists, otherwise for
+// the single legacy file. Returns false when neither could be opened;
+// migrated is set when the data came from the legacy file.
+bool forEachSnapshotFile(const string& dir, const string& legacyPath,
+                         const function<void(MappedFile&)>& fn, bool& migrated);
+
+// Keys of the records changed since the last snapshot, by segment. A record
+// is marked when it turns dirty, so a save finds its work without looking
+// at the records that did not change.
+class DirtyKeys {
+private:
+    vector<vector<string>> keys;
+    SegmentSet segments;
+
+public:
+    DirtyKeys();
+
+    void mark(const string& key);
+    void clear();
+
+    const SegmentSet& marked() const { return segments; }
+    const vector<string>& in(size_t segment) const { return keys[segment]; }
+};
+
+extern DirtyKeys dirtyAccounts;
+extern DirtyKeys dirtyUsers;
+extern DirtyKeys dirtyStores;
+
+// Rows of one segment to swap in, by key, in the order they were given.
+struct SegmentRows {
+    vector<pair<string, string>> rows;
+    unordered_map<string, size_t> byKey;
+};
+
+// Merges changed records into their segment files. A record is identified
+// by the CSV column keyColumn of its rows, and may span several rows.
+class SegmentWriter {
+private:
+    string dir;
+    SegmentSet dirty;
+    size_t keyColumn;
+    vector<SegmentRows> contents;
+
+public:
+    SegmentWriter(const string& dir, const SegmentSet& dirty, size_t keyColumn);
+
+    // Sets all rows of key; an empty string removes them.
+    void replace(size_t segment, const string& key, const string& rows);
+
+    // Rewrites every dirty segment, then the manifest if this is the first
+    // save. Replaced keys keep the place of their old rows and new keys go
+    // last. Nothing is written when no segment is dirty.
+    void commit();
+};
+
+#endif // SNAPSHOT_FILES_H
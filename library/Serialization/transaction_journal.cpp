@@ -0,0 +1,120 @@
+#include <iostream>
+#include <algorithm>
+
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#include "transaction_journal.h"
+
+using namespace std;
+
+namespace {
+
+double microsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TransactionJournal::TransactionJournal(const string& path, const JournalSettings& settings)
+    : path(path), settings(settings), file(nullptr), opened(chrono::steady_clock::now()), stopping(false) {
+    file = fopen(path.c_str(), "ab");
+    if (!file) {
+        cerr << "ERROR: Could not open " << path << " for saving transaction.\n";
+        return;
+    }
+    // The journal does its own buffering.
+    setvbuf(file, nullptr, _IONBF, 0);
+    buffer.reserve(settings.maxBufferBytes + 256);
+
+    if (settings.durability != DURABILITY_NONE) {
+        flusher = thread(&TransactionJournal::flushLoop, this);
+    }
+}
+
+TransactionJournal::~TransactionJournal() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (flusher.joinable()) flusher.join();
+
+    if (file) {
+        lock_guard<mutex> guard(lock);
+        commitLocked();
+        fclose(file);
+    }
+}
+
+void TransactionJournal::append(const string& line) {
+    auto start = chrono::steady_clock::now();
+    bool first = false;
+    {
+        lock_guard<mutex> guard(lock);
+        if (!file) return;
+
+        first = buffer.empty();
+        if (first) oldestBuffered = start;
+        buffer.append(line);
+        buffer.push_back('\n');
+        counters.records++;
+
+        if (buffer.size() >= settings.maxBufferBytes) {
+            commitLocked();
+            first = false;
+        }
+
+        double micros = microsSince(start);
+        counters.appendMicros += micros;
+        counters.maxAppendMicros = max(counters.maxAppendMicros, micros);
+    }
+    // Start the latency clock of the flusher for the new group.
+    if (first) wake.notify_one();
+}
+
+void TransactionJournal::flush() {
+    lock_guard<mutex> guard(lock);
+    commitLocked();
+}
+
+void TransactionJournal::commitLocked() {
+    if (!file || buffer.empty()) return;
+
+    auto start = chrono::steady_clock::now();
+    if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        cerr << "ERROR: Could not write to " << path << ".\n";
+    }
+#if !defined(_WIN32)
+    if (settings.durability == DURABILITY_FSYNC) {
+        fsync(fileno(file));
+    }
+#endif
+    buffer.clear();
+    counters.groups++;
+    counters.commitMicros += microsSince(start);
+}
+
+void TransactionJournal::flushLoop() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+        if (buffer.empty()) {
+            wake.wait(guard);
+            continue;
+        }
+        auto deadline = oldestBuffered + settings.maxLatency;
+        if (chrono::steady_clock::now() >= deadline) {
+            commitLocked();
+        } else {
+            wake.wait_until(guard, deadline);
+        }
+    }
+}
+
+JournalStats TransactionJournal::stats() {
+    lock_guard<mutex> guard(lock);
+    JournalStats result = counters;
+    result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - opened).count();
+    return result;
+}
@@ -0,0 +1,72 @@
+#ifndef TRANSACTION_JOURNAL_H
+#define TRANSACTION_JOURNAL_H
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+using namespace std;
+
+// What a group commit does with the buffered records once a threshold is hit.
+// NONE only hands them to the OS when the buffer is full or on shutdown,
+// FLUSH writes every group, FSYNC also waits for it to reach the disk.
+enum JournalDurability { DURABILITY_NONE, DURABILITY_FLUSH, DURABILITY_FSYNC };
+
+struct JournalSettings {
+    JournalDurability durability = DURABILITY_FLUSH;
+    size_t maxBufferBytes = 64 * 1024;
+    chrono::milliseconds maxLatency{50};
+};
+
+struct JournalStats {
+    uint64_t records = 0;
+    uint64_t groups = 0;
+    double appendMicros = 0.0;     // time spent inside append(), summed
+    double maxAppendMicros = 0.0;
+    double commitMicros = 0.0;     // time spent writing groups, summed
+    double elapsedSeconds = 0.0;
+};
+
+// Append-only text journal that keeps its file open and commits records in
+// groups. A background thread commits a group that has waited maxLatency.
+class TransactionJournal {
+private:
+    string path;
+    JournalSettings settings;
+    FILE* file;
+    string buffer;
+    chrono::steady_clock::time_point oldestBuffered;
+    chrono::steady_clock::time_point opened;
+    JournalStats counters;
+
+    mutex lock;
+    condition_variable wake;
+    bool stopping;
+    thread flusher;
+
+    void commitLocked();
+    void flushLoop();
+
+public:
+    TransactionJournal(const string& path, const JournalSettings& settings);
+    ~TransactionJournal();
+
+    TransactionJournal(const TransactionJournal&) = delete;
+    TransactionJournal& operator=(const TransactionJournal&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Buffers one line; the newline is added here.
+    void append(const string& line);
+
+    // Commits whatever is buffered, regardless of the thresholds.
+    void flush();
+
+    JournalStats stats();
+};
+
+#endif // TRANSACTION_JOURNAL_H
@@ -0,0 +1,227 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+
+#if !defined(_WIN32)
+    #include <unistd.h>
+#endif
+
+#include "wal.h"
+#include "mapped_file.h"
+
+using namespace std;
+
+namespace {
+
+// Frame: payload length, checksum, lsn, type, payload.
+const size_t FRAME_HEADER = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint8_t);
+
+uint32_t checksum(uint64_t lsn, uint8_t type, string_view payload) {
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](const char* bytes, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 16777619u;
+        }
+    };
+    mix(reinterpret_cast<const char*>(&lsn), sizeof(lsn));
+    mix(reinterpret_cast<const char*>(&type), sizeof(type));
+    mix(payload.data(), payload.size());
+    return hash;
+}
+
+WalCheckpoint readCheckpoint(const string& path) {
+    WalCheckpoint marker;
+    ifstream ifs(path);
+    if (ifs.is_open()) {
+        WalCheckpoint loaded;
+        if (ifs >> loaded.lsn >> loaded.ordersFormat >> loaded.ordersBytes) {
+            marker = loaded;
+        }
+    }
+    return marker;
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(const string& path, const string& checkpointPath)
+    : path(path), checkpointPath(checkpointPath), out(nullptr), nextLsn(1), bytes(0), pending(0), recovered(false) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    if (out) fclose(out);
+}
+
+void WriteAheadLog::openForAppend() {
+    if (!recovered) {
+        // Never number a record at or below the last checkpoint.
+        nextLsn = max(nextLsn, readCheckpoint(checkpointPath).lsn + 1);
+        recovered = true;
+    }
+    if (!out) {
+        out = fopen(path.c_str(), "ab");
+        if (!out) {
+            cerr << "ERROR: Could not open " << path << " for logging.\n";
+        }
+        error_code ec;
+        bytes = filesystem::file_size(path, ec);
+        if (ec) bytes = 0;
+    }
+}
+
+vector<WalRecord> WriteAheadLog::recover(WalCheckpoint& checkpoint) {
+    lock_guard<mutex> guard(lock);
+    vector<WalRecord> records;
+    checkpoint = readCheckpoint(checkpointPath);
+    nextLsn = checkpoint.lsn + 1;
+    pending = 0;
+    recovered = true;
+
+    size_t validBytes = 0;
+    size_t fileBytes = 0;
+    {
+        MappedFile file(path);
+        string_view data = file.view();
+        fileBytes = data.size();
+
+        while (data.size() - validBytes >= FRAME_HEADER) {
+            const char* p = data.data() + validBytes;
+            uint32_t length, sum;
+            uint64_t lsn;
+            uint8_t type;
+            memcpy(&length, p, sizeof(length));
+            memcpy(&sum, p + 4, sizeof(sum));
+            memcpy(&lsn, p + 8, sizeof(lsn));
+            memcpy(&type, p + 16, sizeof(type));
+
+            if (data.size() - validBytes - FRAME_HEADER < length) break;
+            string_view payload(p + FRAME_HEADER, length);
+            if (checksum(lsn, type, payload) != sum) break;
+
+            validBytes += FRAME_HEADER + length;
+            if (lsn <= checkpoint.lsn) continue;
+
+            records.push_back({lsn, static_cast<WalRecordType>(type), string(payload)});
+            nextLsn = lsn + 1;
+            pending++;
+        }
+    }
+
+    if (validBytes < fileBytes) {
+        cerr << "Warning: Discarding " << (fileBytes - validBytes) << " torn bytes at the end of " << path << ".\n";
+        error_code ec;
+        filesystem::resize_file(path, validBytes, ec);
+    }
+
+    openForAppend();
+    bytes = validBytes;
+    return records;
+}
+
+void WriteAheadLog::append(WalRecordType type, const string& payload) {
+    lock_guard<mutex> guard(lock);
+    openForAppend();
+
+    uint64_t lsn = nextLsn++;
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    uint32_t sum = checksum(lsn, type, payload);
+
+    char header[FRAME_HEADER];
+    memcpy(header, &length, sizeof(length));
+    memcpy(header + 4, &sum, sizeof(sum));
+    memcpy(header + 8, &lsn, sizeof(lsn));
+    memcpy(header + 16, &type, sizeof(type));
+
+    if (out) {
+        if (fwrite(header, 1, sizeof(header), out) != sizeof(header) ||
+            fwrite(payload.data(), 1, payload.size(), out) != payload.size() || fflush(out) != 0) {
+            cerr << "ERROR: Could not write to " << path << ".\n";
+        }
+#if !defined(_WIN32)
+        fsync(fileno(out));
+#endif
+        bytes += sizeof(header) + payload.size();
+    }
+    pending++;
+}
+
+WalPosition WriteAheadLog::position() {
+    lock_guard<mutex> guard(lock);
+    openForAppend();
+    WalPosition at;
+    at.lsn = nextLsn - 1;
+    at.bytes = bytes;
+    return at;
+}
+
+size_t WriteAheadLog::pendingRecords() const {
+    lock_guard<mutex> guard(lock);
+    return pending;
+}
+
+// Replaces the log with its bytes from the offset on; out is closed. The
+// copy is synced before the rename, since it holds the only copy of them.
+void WriteAheadLog::keepTail(uint64_t from) {
+    string tail;
+    {
+        ifstream ifs(path, ios::binary);
+        ifs.seekg(static_cast<streamoff>(from));
+        tail.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+    }
+
+    string tmpPath = path + ".tmp";
+    FILE* copy = fopen(tmpPath.c_str(), "wb");
+    if (!copy) {
+        cerr << "ERROR: Could not write " << tmpPath << ". Log kept whole.\n";
+        return;
+    }
+    bool written = fwrite(tail.data(), 1, tail.size(), copy) == tail.size() && fflush(copy) == 0;
+#if !defined(_WIN32)
+    written = written && fsync(fileno(copy)) == 0;
+#endif
+    fclose(copy);
+
+    error_code ec;
+    if (written) filesystem::rename(tmpPath, path, ec);
+    if (!written || ec) {
+        cerr << "ERROR: Could not write " << tmpPath << ". Log kept whole.\n";
+        return;
+    }
+    bytes = tail.size();
+}
+
+void WriteAheadLog::checkpoint(WalCheckpoint marker, WalPosition at) {
+    marker.lsn = at.lsn;
+
+    string tmpPath = checkpointPath + ".tmp";
+    {
+        ofstream ofs(tmpPath, ios::trunc);
+        if (!ofs.is_open()) {
+            cerr << "ERROR: Could not write " << checkpointPath << ". Log kept for replay.\n";
+            return;
+        }
+        ofs << marker.lsn << " " << marker.ordersFormat << " " << marker.ordersBytes << "\n";
+    }
+    error_code ec;
+    filesystem::rename(tmpPath, checkpointPath, ec);
+    if (ec) {
+        cerr << "ERROR: Could not write " << checkpointPath << ". Log kept for replay.\n";
+        return;
+    }
+
+    // Recovery skips the records up to the marker, so a log left whole by a
+    // failure below is still correct, only longer.
+    lock_guard<mutex> guard(lock);
+    if (out) fclose(out);
+    out = nullptr;
+    if (bytes > at.bytes) {
+        keepTail(at.bytes);
+    } else {
+        out = fopen(path.c_str(), "wb");
+        bytes = 0;
+    }
+    if (!out) out = fopen(path.c_str(), "ab");
+    pending = static_cast<size_t>(nextLsn - 1 - at.lsn);
+}
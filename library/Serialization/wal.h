@@ -0,0 +1,87 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <mutex>
+
+using namespace std;
+
+// Typed mutation records. Payloads are short CSV strings built by the
+// serialization layer; the log itself only frames and checksums them.
+// Balances and stock are logged as the value after the change, so replaying
+// a record the snapshots already hold changes nothing. The delta types are
+// only read, from logs written before that.
+enum WalRecordType : uint8_t {
+    WAL_BALANCE_DELTA = 1,
+    WAL_STOCK_DELTA   = 2,
+    WAL_ORDER_INSERT  = 3,
+    WAL_USER_UPSERT   = 4,
+    WAL_BALANCE_SET   = 5,
+    WAL_STOCK_SET     = 6
+};
+
+struct WalRecord {
+    uint64_t lsn;
+    WalRecordType type;
+    string payload;
+};
+
+// What the snapshot files contained at the last checkpoint. ordersBytes is
+// the size of the order file then, so an append interrupted by a crash can
+// be cut off before the log is replayed on top of it.
+struct WalCheckpoint {
+    uint64_t lsn = 0;
+    int ordersFormat = -1;
+    uint64_t ordersBytes = 0;
+};
+
+// The last record appended and the log size after it.
+struct WalPosition {
+    uint64_t lsn = 0;
+    uint64_t bytes = 0;
+};
+
+// Appends come from the request thread; a checkpoint may finish on another.
+class WriteAheadLog {
+private:
+    string path;
+    string checkpointPath;
+    FILE* out;
+    uint64_t nextLsn;
+    uint64_t bytes;
+    size_t pending;
+    bool recovered;
+    mutable mutex lock;
+
+    void openForAppend();
+    void keepTail(uint64_t from);
+
+public:
+    WriteAheadLog(const string& path, const string& checkpointPath);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Returns every intact record logged after the last checkpoint and cuts
+    // off a torn tail left by a crash mid-append.
+    vector<WalRecord> recover(WalCheckpoint& checkpoint);
+
+    // Returns once the record is on disk (fsync), so the caller may report
+    // the mutation as done.
+    void append(WalRecordType type, const string& payload);
+
+    WalPosition position();
+
+    // Records that the snapshots cover everything logged up to at. The
+    // records appended after it stay in the log, which is otherwise emptied.
+    void checkpoint(WalCheckpoint marker, WalPosition at);
+
+    // Records logged since the position of the last checkpoint.
+    size_t pendingRecords() const;
+};
+
+#endif // WAL_H
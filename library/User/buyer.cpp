@@ -12,9 +12,14 @@
 #include "../Item/order.h"
 #include "../Item/item.h"
 #include "../User/user.h"
+#include "../User/seller.h"
+#include "../Item/inventory_service.h"
+#include "../Item/order_index.h"
+#include "../Serialization/serialization.h"
 
 using namespace std;
 extern std::vector<Order> orders;
+extern std::vector<std::shared_ptr<User>> users;
 extern void loadOrders(std::vector<Order>&);
 
 Buyer::Buyer(const string& name, const string& password)
@@ -57,114 +62,40 @@ string Buyer::userToCSV() const {
     return getName() + "," + password + "," + getRole() + ",";
 }
 
-void Buyer::updateInventoryCSV(const map<string, vector<InventoryItem>>& allStoreInventory, const string& filename) {
-	ofstream file("data/" + filename);
-
-	if (!file.is_open()) {
-		cerr << "Error: Could not open data/" << filename << " for writing. Inventory update failed.\n";
-		return;
-	}
-
-	for (const auto& storePair : allStoreInventory) {
-		const string& storeName = storePair.first;
-		for (const auto& item : storePair.second) {
-			if (item.quantity > 0) { 
-				file << storeName << ","
-					 << item.id << ","
-					 << item.name << ","
-					 << item.quantity << ","
-					 << fixed << setprecision(2) << item.price << "\n";
-			}
-		}
-	}
-	file.close();
+void Buyer::recordOrder(const Order& order) {
+	orders.push_back(order);
+	logOrderInsert(order);
 }
 
-void Buyer::recordOrder(const Order& order, const string& filename) {
-	ofstream file("data/" + filename, ios::app);
-	
-	if (!file.is_open()) {
-		cerr << "Error: Could not open data/" << filename << " for writing. Order recording failed.\n";
+// Reads and changes the stock held by the inventory service; the inventory
+// files only catch up at checkpoints.
+void Buyer::purchaseItem(const string& storeName, int itemId, int purchaseQty) {
+	const Item* stocked = inventoryService.findItem(storeName, itemId);
+	if (!stocked) {
+		cerr << "[ERROR] Item " << itemId << " not found in store: " << storeName << "\n";
 		return;
 	}
-
-	file << order.toCSV() << "\n";
-	
-	file.close();
-}
-
-void Buyer::loadInventoryFromCSV(map<string, vector<InventoryItem>>& allStoreInventory, const string& filename) {
-    allStoreInventory.clear();
-
-    ifstream file("data/" + filename);
-
-    if (!file.is_open()) {
-        file.open("../data/" + filename);
-    }
-    
-    if (!file.is_open()) {
-        file.open(filename);
-    }
-
-    if (!file.is_open()) {
-        cout << "Warning: Could not open " << filename << ". Checked multiple paths relative to 'data/' folder. Please verify file location.\n";
-        return;
-    }
-
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string segment;
-        vector<string> tokens;
-        
-        while (getline(ss, segment, ',')) {
-            tokens.push_back(segment);
-        }
-
-        if (tokens.size() >= 5) {
-            try {
-                string storeName = tokens[0];
-                InventoryItem item;
-                item.id = stoi(tokens[1]);
-                item.name = tokens[2];
-                item.quantity = stoi(tokens[3]);
-                item.price = stod(tokens[4]);
-                allStoreInventory[storeName].push_back(item);
-            } catch (...) {
-            }
-        }
-    }
-    file.close();
-}
-
-void Buyer::purchaseItem(
-	const string& storeName, 
-	const InventoryItem& itemData, 
-	int purchaseQty,
-	map<string, vector<InventoryItem>>& currentInventory) {
-	
-	const string inventoryFile = "inventory.csv";
-	const string ordersFile = "orders.csv";       
+	Item itemData = *stocked;
 
 	if (!getAccount()) {
 		cout << "\n[PURCHASE FAILED] Please create a bank account first to make a purchase.\n";
 		return;
 	}
 
-    double totalCost = itemData.price * purchaseQty; 
+    double totalCost = itemData.getPrice() * purchaseQty; 
 	
 	int newOrderId = 10000 + (chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count() % 9999);
 	
-	Item purchasedItem(itemData.id, itemData.name, purchaseQty, itemData.price);
+	Item purchasedItem(itemData.getId(), itemData.getName(), purchaseQty, itemData.getPrice());
 
-	if (purchaseQty > itemData.quantity) {
-		cout << "\n[PURCHASE FAILED] Insufficient stock. Available: " << itemData.quantity << ".\n";
+	if (purchaseQty > itemData.getQuantity()) {
+		cout << "\n[PURCHASE FAILED] Insufficient stock. Available: " << itemData.getQuantity() << ".\n";
 
 		Order incompleteOrder(newOrderId, this->getName(), storeName);
 		incompleteOrder.addItem(purchasedItem);
 		incompleteOrder.setTotalAmount(totalCost); 
-		incompleteOrder.setStatus("INCOMPLETE");
-		recordOrder(incompleteOrder, ordersFile);
+		incompleteOrder.setStatus(STATUS_INCOMPLETE);
+		recordOrder(incompleteOrder);
 
 		cout << "[ORDER INCOMPLETE] Transaction recorded (Insufficient Stock).\n";
 		return;
@@ -178,8 +109,8 @@ void Buyer::purchaseItem(
 		Order canceledOrder(newOrderId, this->getName(), storeName);
 		canceledOrder.addItem(purchasedItem);
 		canceledOrder.setTotalAmount(totalCost); 
-		canceledOrder.setStatus("CANCELED");
-		recordOrder(canceledOrder, ordersFile);
+		canceledOrder.setStatus(STATUS_CANCELED);
+		recordOrder(canceledOrder);
 
 		cout << "[ORDER CANCELED] Transaction recorded with CANCELED status (Insufficient Balance).\n\n";
 		return;
@@ -188,27 +119,18 @@ void Buyer::purchaseItem(
 	Order successOrder(newOrderId, this->getName(), storeName);
 	successOrder.addItem(purchasedItem);
 	successOrder.setTotalAmount(totalCost); 
-	successOrder.setStatus("DONE"); 
-	recordOrder(successOrder, ordersFile);
+	successOrder.setStatus(STATUS_DONE); 
+	recordOrder(successOrder);
 
 	withdraw(totalCost); 
 	
-	try {
-		for (auto& itemRef : currentInventory.at(storeName)) {
-			if (itemRef.id == itemData.id) {
-				itemRef.quantity -= purchaseQty;
-				cout << "\n[PURCHASE SUCCESS] Bought " << purchaseQty << "x " << itemData.name 
-					 << " for Rp" << fixed << setprecision(2) << totalCost << ".\n";
-				cout << "Remaining balance: Rp" << fixed << setprecision(2) << getBalance() << ".\n";
-				cout << "Remaining stock: " << itemRef.quantity << ".\n";
-				break;
-			}
-		}
-	} catch (const out_of_range& e) {
-		cerr << "[ERROR] Store name not found in inventory map: " << storeName << "\n";
-	}
-	
-	updateInventoryCSV(currentInventory, inventoryFile);
+	inventoryService.adjustQuantity(storeName, itemId, -purchaseQty);
+	logStock(storeName, itemId, itemData.getQuantity() - purchaseQty);
+
+	cout << "\n[PURCHASE SUCCESS] Bought " << purchaseQty << "x " << itemData.getName() 
+		 << " for Rp" << fixed << setprecision(2) << totalCost << ".\n";
+	cout << "Remaining balance: Rp" << fixed << setprecision(2) << getBalance() << ".\n";
+	cout << "Remaining stock: " << itemData.getQuantity() - purchaseQty << ".\n";
 	
 	cout << "Transaction recorded with DONE status.\n\n";
 }
@@ -222,18 +144,11 @@ double Buyer::calculateSpendingLastKDays(int days) const {
     auto timeLimit = now - timeLimitDuration;
 
     loadOrders(orders); 
-    const vector<Order>& allOrders = orders;
-    
-    for (const auto& order : allOrders) {
-        if (order.getBuyerName() != this->getName()) {
-            continue;
-        }
-
-        if (order.getStatus() != "DONE") {
-            continue;
-        }
-
-        if (order.getCreationTime() >= timeLimit) {
+    // The buyer's orders are sorted by creation time; skip to the window.
+    const vector<uint32_t>& myOrders = orderIndex.ordersOfBuyer(this->getName());
+    for (size_t i = orderIndex.firstSince(myOrders, timeLimit); i < myOrders.size(); ++i) {
+        const Order& order = orders[myOrders[i]];
+        if (order.getStatus() == STATUS_DONE) {
             totalSpending += order.getTotalAmount();
         }
     }
@@ -242,20 +157,14 @@ double Buyer::calculateSpendingLastKDays(int days) const {
 }
 
 void Buyer::handleBrowseStore() {
-	map<string, vector<InventoryItem>> currentInventory;
-	const string inventoryFile = "inventory.csv";
-	loadInventoryFromCSV(currentInventory, inventoryFile);
+	vector<string> storeNames = inventoryService.storesInStock();
 
-	if (currentInventory.empty()) {
+	if (storeNames.empty()) {
 		cout << "No stores or items found in inventory.\n\n";
 		return;
 	}
 
 	int choice = 0;
-	vector<string> storeNames;
-	for (const auto& pair : currentInventory) {
-		storeNames.push_back(pair.first);
-	}
 	
 	const int numStores = static_cast<int>(storeNames.size());
 	const int backOption = numStores + 1;
@@ -281,15 +190,23 @@ void Buyer::handleBrowseStore() {
 		}
 
 		const string& selectedStoreName = storeNames[choice - 1]; 
-		if (currentInventory.count(selectedStoreName) == 0) {
+
+		// Items in stock when the store is opened keep their numbers while
+		// it is shown; quantities are read live.
+		vector<int> itemIds;
+		for (const auto& item : inventoryService.items(selectedStoreName)) {
+			if (item.getQuantity() > 0) {
+				itemIds.push_back(item.getId());
+			}
+		}
+		if (itemIds.empty()) {
 			cout << "Store not found. Please try again.\n";
 			continue;
 		}
-		const auto& items = currentInventory.at(selectedStoreName);
 		
 		int itemChoice = 0;
 		int purchaseQty = 0;
-		const int numItems = static_cast<int>(items.size());
+		const int numItems = static_cast<int>(itemIds.size());
 		const int itemBackOption = numItems + 1;
 
 		do {
@@ -298,12 +215,14 @@ void Buyer::handleBrowseStore() {
 			cout << "----------------------------------------------------------------\n";
 			 
 			int j = 1;
-			for (const auto& item : items) {
-				cout << setw(5) << item.id 
+			for (int itemId : itemIds) {
+				const Item* item = inventoryService.findItem(selectedStoreName, itemId);
+				if (!item) continue;
+				cout << setw(5) << item->getId() 
 					 << setw(5) << j++
-					 << setw(30) << item.name 
-					 << setw(10) << item.quantity 
-					 << setw(15) << fixed << setprecision(2) << item.price << "\n";
+					 << setw(30) << item->getName() 
+					 << setw(10) << item->getQuantity() 
+					 << setw(15) << fixed << setprecision(2) << item->getPrice() << "\n";
 			}
 			cout << itemBackOption << ". Back to Store List\n";
 			cout << "----------------------------------------------------------------\n";
@@ -325,9 +244,13 @@ void Buyer::handleBrowseStore() {
 				continue;
 			}
 
-			const InventoryItem& selectedItem = items[itemChoice - 1];
+			const Item* selectedItem = inventoryService.findItem(selectedStoreName, itemIds[itemChoice - 1]);
+			if (!selectedItem) {
+				cout << "Invalid item selection.\n";
+				continue;
+			}
 			
-			cout << "Enter quantity for " << selectedItem.name << " (Available: " << selectedItem.quantity << "): ";
+			cout << "Enter quantity for " << selectedItem->getName() << " (Available: " << selectedItem->getQuantity() << "): ";
 			if (!(cin >> purchaseQty) || purchaseQty <= 0) {
 				cout << "Invalid quantity or input.\n";
 				cin.clear();
@@ -335,9 +258,7 @@ void Buyer::handleBrowseStore() {
 				continue;
 			}
 
-			purchaseItem(selectedStoreName, selectedItem, purchaseQty, currentInventory);
-			
-			loadInventoryFromCSV(currentInventory, inventoryFile); 
+			purchaseItem(selectedStoreName, selectedItem->getId(), purchaseQty);
 
 		} while (true);
 		
@@ -381,35 +302,33 @@ void Buyer::handleOrderFunctionality() {
 void Buyer::viewMyOrderHistory() const {
     try {
         loadOrders(orders);
-        const vector<Order>& allOrders = orders;
 
         cout << "\n-- MY ORDER HISTORY (" << this->getName() << ") --\n";
         bool found = false;
 
-        for (const auto& order : allOrders) {
-            if (order.getBuyerName() == this->getName()) {
-                found = true;
-
-                double calculatedTotal = 0.0; 
-
-                cout << "\n---------------------------------------------------\n";
-                cout << "Order ID: " << order.getOrderId() << "\n";
-                cout << "Seller: " << order.getSellerStoreName() << "\n";
-                cout << "Status: " << order.getStatus() << "\n";
-                cout << "Creation Time: " << order.getFormattedCreationTime() << "\n"; 
-
-                cout << "\nItem Details:\n";
-                cout << setw(35) << left << "  - Item" << setw(10) << "Qty" << setw(15) << "Subtotal (Rp)\n";
-                cout << "  ---------------------------------------------------\n";
+        for (uint32_t position : orderIndex.ordersOfBuyer(this->getName())) {
+            const Order& order = orders[position];
+            found = true;
+
+            double calculatedTotal = 0.0; 
+
+            cout << "\n---------------------------------------------------\n";
+            cout << "Order ID: " << order.getOrderId() << "\n";
+            cout << "Seller: " << order.getSellerStoreName() << "\n";
+            cout << "Status: " << order.getStatusName() << "\n";
+            cout << "Creation Time: " << order.getFormattedCreationTime() << "\n"; 
+
+            cout << "\nItem Details:\n";
+            cout << setw(35) << left << "  - Item" << setw(10) << "Qty" << setw(15) << "Subtotal (Rp)\n";
+            cout << "  ---------------------------------------------------\n";
+            
+            for (const auto& item : order.getItems()) {
+                double itemSubtotal = item.getPrice() * item.getQuantity();
+                calculatedTotal += itemSubtotal;
                 
-                for (const auto& item : order.getItems()) {
-                    double itemSubtotal = item.getPrice() * item.getQuantity();
-                    calculatedTotal += itemSubtotal;
-                    
-                    cout << setw(35) << left << ("  - " + item.getName()) 
-                         << setw(10) << item.getQuantity()
-                         << setw(15) << fixed << setprecision(2) << itemSubtotal << "\n";
-                }
+                cout << setw(35) << left << ("  - " + item.getName()) 
+                     << setw(10) << item.getQuantity()
+                     << setw(15) << fixed << setprecision(2) << itemSubtotal << "\n";
             }
         }
 
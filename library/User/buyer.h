@@ -17,19 +17,11 @@ class Item;
 
 using namespace std;
 
-struct InventoryItem {
-    int id;
-    string name;
-    int quantity;
-    double price;
-};
-
 class Buyer : public User {
 private:
     int id;
 
-    static void updateInventoryCSV(const map<string, vector<InventoryItem>>& allStoreInventory, const string& filename = "inventory.csv");
-	static void recordOrder(const Order& order, const string& filename = "orders.csv");
+	static void recordOrder(const Order& order);
 
 public:
     Buyer(const string& name, const string& password);
@@ -37,16 +29,10 @@ public:
     Buyer(const string& name, const string& password, shared_ptr<BankCustomer> acc) 
         : User(name, password, acc) {}
 
-    static void loadInventoryFromCSV(map<string, vector<InventoryItem>>& allStoreInventory, const string& filename = "inventory.csv");
     void handleBrowseStore();
     void handleOrderFunctionality();
 
-    void purchaseItem(
-		const string& storeName, 
-		const InventoryItem& itemData,
-		int purchaseQty,
-		map<string, vector<InventoryItem>>& currentInventory
-	);
+    void purchaseItem(const string& storeName, int itemId, int purchaseQty);
 
     bool withdraw(double amount);
 
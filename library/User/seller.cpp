@@ -5,12 +5,18 @@
 #include <cstdlib>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include "./seller.h"
 #include "../Bank/bank_customer.h"
 #include "../Item/item.h"
 #include "../Item/order.h"
 #include "../Item/analytics.h"
+#include "../Item/inventory_service.h"
+#include "../Item/order_index.h"
+#include "../Item/sales_sketch.h"
+#include "../Item/parallel_reduce.h"
+#include "../Serialization/civil_time.h"
 
 
 extern vector<Order> orders; 
@@ -32,21 +38,21 @@ string Seller::userToCSV() const {
 }
 
 string Seller::inventoryToCSV() const {
-    stringstream ss;
-    for (const auto& item : items) {
-        ss << storeName << "," << item.toCSV() << "\n";
+    string rows;
+    for (const auto& item : getItems()) {
+        rows += storeName;
+        rows += ',';
+        item.appendCSV(rows);
+        rows += '\n';
     }
-    return ss.str();
+    return rows;
 }
 
 // Mengubah timepoint menjadi string
 string formatTimePoint(chrono::system_clock::time_point tp) {
-    time_t tt = chrono::system_clock::to_time_t(tp);
-    tm tm = *localtime(&tt);
-    
-    stringstream ss;
-    ss << put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    char buffer[CIVIL_TIME_LENGTH];
+    if (!formatLocalTime(tp, buffer)) return "UnknownTime";
+    return string(buffer, CIVIL_TIME_LENGTH);
 }
 
 string Seller::getRole() const {
@@ -73,13 +79,22 @@ double Seller::getBalance() const {
     return 0.0;
 }
 
+const vector<Item>& Seller::getItems() const {
+    return inventoryService.items(storeName);
+}
+
 void Seller::addItem(int id, const string& name, int qty, double price) {
-    items.emplace_back(id, name, qty, price);
+    inventoryService.addItem(storeName, Item(id, name, qty, price));
     cout << "Item " << name << " added to inventory.\n\n";
 }
 
+void Seller::addItemObject(const Item& item) {
+    inventoryService.addItem(storeName, item);
+}
+
 void Seller::showInventory() const {
     cout << "\n-- Store Inventory: --\n";
+    const vector<Item>& items = getItems();
     if (items.empty()) {
         cout << "Inventory is empty.\n\n";
         return;
@@ -95,32 +110,72 @@ void Seller::showInventory() const {
 }
 
 void Seller::removeItem(int id) {
-    auto it = remove_if(items.begin(), items.end(), 
-                             [id](const Item& item) {
-                                 return item.getId() == id;
-                             });
-                             
-    if (it != items.end()) {
-        items.erase(it, items.end());
+    if (inventoryService.removeItem(storeName, id)) {
         cout << "Item with ID " << id << " removed.\n\n";
     } else {
         cout << "Item with ID " << id << " not found.\n\n";
     }
 }
 
+bool Seller::isInventoryDirty() const {
+    return inventoryService.isDirty(storeName);
+}
+
+void Seller::clearInventoryDirty() {
+    inventoryService.clearDirty(storeName);
+}
+
+bool Seller::adjustItemQuantity(int itemId, int delta) {
+    return inventoryService.adjustQuantity(storeName, itemId, delta);
+}
+
+// Footer of the reports answered from the sales sketches.
+void printSketchBounds(const SalesSummary& summary, const string& unit) {
+    cout << "(Approximate: " << summary.totalWeight() << " " << unit << " in "
+         << salesSketches.getSettings().counters << " counters. Each count is at most "
+         << summary.spaceSavingError() << " too high, and within " << summary.countMinError()
+         << " with " << static_cast<int>(summary.countMinConfidence() * 100) << "% confidence.)\n";
+}
+
 void Seller::viewMostFrequentItems(int mItems) const {
-    map<int, int> itemFrequency;
-    map<int, string> itemIdToName;
-
-    for (const auto& order : orders) {
-        if (order.getSellerStoreName() == this->storeName && order.getStatus() == "DONE") {
-            for (const auto& item : order.getItems()) {
-                itemFrequency[item.getId()] += item.getQuantity();
-                itemIdToName[item.getId()] = item.getName();
-            }
+    const StoreSales* sales = salesSketches.salesOf(storeName);
+    if (salesSketches.approximate(sales)) {
+        vector<TopEstimate> top = sales->items->top(mItems > 0 ? static_cast<size_t>(mItems) : SIZE_MAX);
+        cout << "\n-- TOP " << top.size() << " MOST FREQUENT ITEMS SOLD by " << this->storeName << " (approximate) --\n";
+        for (size_t i = 0; i < top.size(); ++i) {
+            cout << left << setw(3) << (i + 1) << ". "
+                 << setw(30) << symbols.name(top[i].tag)
+                 << " (ID: " << setw(5) << static_cast<int>(top[i].key) << ")"
+                 << " | Quantity Sold: ~" << top[i].upper << " (at least " << top[i].lower << ")\n";
         }
+        printSketchBounds(*sales->items, "units sold");
+        cout << "\n";
+        return;
     }
 
+    // Per shard: quantity per item id and the last name seen for it.
+    struct ItemTally {
+        map<int, int> quantity;
+        map<int, Symbol> name;
+    };
+    const vector<uint32_t>& positions = orderIndex.ordersOfStore(storeName);
+    ItemTally tally = mapReduce<ItemTally>(positions.size(),
+        [&positions](ItemTally& part, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Order& order = orders[positions[i]];
+                if (order.getStatus() != STATUS_DONE) continue;
+                for (const auto& item : order.getItems()) {
+                    part.quantity[item.getId()] += item.getQuantity();
+                    part.name[item.getId()] = item.getNameSymbol();
+                }
+            }
+        },
+        [](ItemTally& into, const ItemTally& from) {
+            for (const auto& q : from.quantity) into.quantity[q.first] += q.second;
+            for (const auto& n : from.name) into.name[n.first] = n.second;
+        });
+    const map<int, int>& itemFrequency = tally.quantity;
+
     if (itemFrequency.empty()) {
         cout << "\n-- TOP " << mItems << " MOST FREQUENT ITEMS SOLD by " << this->storeName << " --\n";
         cout << "No completed transactions found for the store.\n\n";
@@ -142,7 +197,7 @@ void Seller::viewMostFrequentItems(int mItems) const {
     for (int i = 0; i < limit; ++i) {
         int itemId = itemsVec[i].first;
         int quantity = itemsVec[i].second;
-        const string& itemName = itemIdToName[itemId];
+        const string& itemName = symbols.name(tally.name[itemId]);
 
         cout << left << setw(3) << (i + 1) << ". "
                 << setw(30) << itemName
@@ -156,24 +211,23 @@ void Seller::viewOrders() const {
     cout << "-- Paid Status Order --" << " ==\n";
     bool foundPaidOrder = false;
 
-    for(const auto& order : orders) {
-        if(order.getSellerStoreName() == this-> storeName) {
-            if (order.getStatus() == "DONE") {
-                foundPaidOrder = true;
-                
-                cout << "Order ID: " << order.getOrderId() << "\n";
-                cout << "Buyer Detail: " << order.getBuyerName() << "\n";
-                cout << "Order Status: " << order.getStatus() << " (Paid)\n";
-                cout << "Total transaction: Rp" << fixed << setprecision(2) << order.getTotalAmount() << "\n";
-                
-                cout << "-- List Items --\n";
-                for (const auto& item : order.getItems()) { 
-                    cout << "  - Product: " << item.getName() 
-                         << " (ID: " << item.getId() << ")"
-                         << "\n    Quantity: " << item.getQuantity() 
-                         << " x Rp" << fixed << setprecision(0) << item.getPrice() 
-                         << " = Subtotal: Rp" << fixed << setprecision(2) << item.getQuantity() * item.getPrice() << "\n\n";
-                }
+    for (uint32_t position : orderIndex.ordersOfStore(storeName)) {
+        const Order& order = orders[position];
+        if (order.getStatus() == STATUS_DONE) {
+            foundPaidOrder = true;
+            
+            cout << "Order ID: " << order.getOrderId() << "\n";
+            cout << "Buyer Detail: " << order.getBuyerName() << "\n";
+            cout << "Order Status: " << order.getStatusName() << " (Paid)\n";
+            cout << "Total transaction: Rp" << fixed << setprecision(2) << order.getTotalAmount() << "\n";
+            
+            cout << "-- List Items --\n";
+            for (const auto& item : order.getItems()) { 
+                cout << "  - Product: " << item.getName() 
+                     << " (ID: " << item.getId() << ")"
+                     << "\n    Quantity: " << item.getQuantity() 
+                     << " x Rp" << fixed << setprecision(0) << item.getPrice() 
+                     << " = Subtotal: Rp" << fixed << setprecision(2) << item.getQuantity() * item.getPrice() << "\n\n";
             }
         }
     }
@@ -182,22 +236,72 @@ void Seller::viewOrders() const {
     }
 }
 
+// Counts of one store's DONE orders in a flat array by month key, from
+// firstMonth on; months without sales stay empty.
+struct MonthlyTally {
+    int32_t firstMonth = 0;
+    vector<unordered_map<Symbol, int>> months;
+
+    unordered_map<Symbol, int>& at(int32_t month) {
+        if (months.empty()) {
+            firstMonth = month;
+        } else if (month < firstMonth) {
+            months.insert(months.begin(), static_cast<size_t>(firstMonth - month), {});
+            firstMonth = month;
+        }
+        size_t slot = static_cast<size_t>(month - firstMonth);
+        if (slot >= months.size()) months.resize(slot + 1);
+        return months[slot];
+    }
+};
+
+// Per month of the DONE orders at the positions: quantity sold per item
+// name, or number of orders per buyer. Counted in parallel shards.
+MonthlyTally tallyMonthly(const vector<uint32_t>& positions, bool byItem) {
+    return mapReduce<MonthlyTally>(positions.size(),
+        [&positions, byItem](MonthlyTally& part, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Order& order = orders[positions[i]];
+                if (order.getStatus() != STATUS_DONE) continue;
+                auto& month = part.at(order.getMonthKey());
+                if (!byItem) {
+                    month[order.getBuyerSymbol()]++;
+                    continue;
+                }
+                for (const auto& item : order.getItems()) {
+                    month[item.getNameSymbol()] += item.getQuantity();
+                }
+            }
+        },
+        [](MonthlyTally& into, const MonthlyTally& from) {
+            for (size_t i = 0; i < from.months.size(); ++i) {
+                if (from.months[i].empty()) continue;
+                auto& counts = into.at(from.firstMonth + static_cast<int32_t>(i));
+                for (const auto& count : from.months[i]) counts[count.first] += count.second;
+            }
+        });
+}
+
+// The reports list names in name order, as they always have.
+map<string, int> namedCounts(const unordered_map<Symbol, int>& counts) {
+    map<string, int> named;
+    for (const auto& count : counts) named[symbols.name(count.first)] += count.second;
+    return named;
+}
+
 void Seller::handlePopularItemsReport() {
     loadOrders(orders);
-    const vector<Order>& allOrders = orders;
-
-    map<string, map<string, int>> monthlyItemSales;
 
-    for (const auto& order : allOrders) {
-        if (order.getStatus() == "DONE" && order.getSellerStoreName() == this->storeName) {
-            string yearMonth = order.getYearMonthString();
-            for (const auto& item : order.getItems()) {
-                monthlyItemSales[yearMonth][item.getName()] += item.getQuantity();
-            }
-        }
+    const StoreSales* sales = salesSketches.salesOf(storeName);
+    if (salesSketches.approximate(sales)) {
+        handleEstimatedPopularItemsReport(*sales);
+        return;
     }
 
-    if (monthlyItemSales.empty()) {
+    MonthlyTally monthlyItemSales = tallyMonthly(orderIndex.ordersOfStore(storeName), true);
+
+    if (all_of(monthlyItemSales.months.begin(), monthlyItemSales.months.end(),
+               [](const auto& month) { return month.empty(); })) {
         cout << "\nNo sales data found for store " << this->storeName << ".\n\n";
         return;
     }
@@ -211,9 +315,10 @@ void Seller::handlePopularItemsReport() {
     }
 
     cout << "\n=== TOP " << k << " POPULAR ITEMS PER MONTH (" << this->storeName << ") ===\n";
-    for (const auto& monthPair : monthlyItemSales) {
-        const string& month = monthPair.first;
-        const auto& itemSales = monthPair.second;
+    for (size_t slot = 0; slot < monthlyItemSales.months.size(); ++slot) {
+        if (monthlyItemSales.months[slot].empty()) continue;
+        string month = monthKeyName(monthlyItemSales.firstMonth + static_cast<int32_t>(slot));
+        map<string, int> itemSales = namedCounts(monthlyItemSales.months[slot]);
 
         vector<pair<string, int>> sortedItems;
         for (const auto& salesPair : itemSales) {
@@ -238,20 +343,68 @@ void Seller::handlePopularItemsReport() {
     cout << "\n\n";
 }
 
-void Seller::handleLoyalCustomerReport() {
-    loadOrders(orders);
-    const vector<Order>& allOrders = orders;
+void Seller::handleEstimatedPopularItemsReport(const StoreSales& sales) const {
+    int k;
+    cout << "\n[POPULAR ITEMS REPORT - " << this->storeName << "] Enter the Top K item limit per month (e.g., 5): ";
+    if (!(cin >> k) || k <= 0) {
+        cin.clear(); cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid input. Using default K=5.\n";
+        k = 5;
+    }
 
-    map<string, map<string, int>> monthlyCustomerLoyalty;
+    cout << "\n=== TOP " << k << " POPULAR ITEMS PER MONTH (" << this->storeName << ", approximate) ===\n";
+    for (const auto& month : sales.months) {
+        cout << "\n--- Month: " << monthKeyName(month.month) << " ---\n";
+        cout << setw(5) << left << "Rank" << setw(30) << "Item Name" << setw(15) << "Total Quantity" << "At Least\n";
+        cout << "------------------------------------------------\n";
 
-    for (const auto& order : allOrders) {
-        if (order.getStatus() == "DONE" && order.getSellerStoreName() == this->storeName) {
-            string yearMonth = order.getYearMonthString();
-            monthlyCustomerLoyalty[yearMonth][order.getBuyerName()]++;
+        vector<TopEstimate> top = month.items.top(static_cast<size_t>(k));
+        for (size_t i = 0; i < top.size(); ++i) {
+            cout << setw(5) << left << (i + 1)
+                 << setw(30) << symbols.name(top[i].key)
+                 << setw(15) << top[i].upper << top[i].lower << "\n";
         }
+        printSketchBounds(month.items, "units sold");
     }
+    cout << "\n\n";
+}
+
+void Seller::handleEstimatedLoyalCustomerReport(const StoreSales& sales) const {
+    cout << "\n=== MOST LOYAL CUSTOMERS PER MONTH (" << this->storeName << ", approximate) ===\n";
+    cout << "(Based on number of DONE orders)\n";
+
+    for (const auto& month : sales.months) {
+        vector<TopEstimate> top = month.customers.top(SIZE_MAX);
+        stringstream loyalList;
+        for (size_t i = 0; i < top.size() && top[i].upper == top[0].upper; ++i) {
+            if (i > 0) loyalList << ", ";
+            loyalList << symbols.name(top[i].key);
+        }
+
+        cout << "\n--- Month: " << monthKeyName(month.month) << " ---\n";
+        cout << setw(30) << left << "Most Loyal Customer:" 
+             << (top.empty() ? "N/A" : loyalList.str()) << "\n";
+        cout << setw(30) << left << "Number of DONE Orders:" 
+             << "~" << (top.empty() ? 0 : top[0].upper)
+             << " (at least " << (top.empty() ? 0 : top[0].lower) << ")\n";
+        printSketchBounds(month.customers, "orders");
+    }
+    cout << "\n\n";
+}
+
+void Seller::handleLoyalCustomerReport() {
+    loadOrders(orders);
+
+    const StoreSales* sales = salesSketches.salesOf(storeName);
+    if (salesSketches.approximate(sales)) {
+        handleEstimatedLoyalCustomerReport(*sales);
+        return;
+    }
+
+    MonthlyTally monthlyCustomerLoyalty = tallyMonthly(orderIndex.ordersOfStore(storeName), false);
 
-    if (monthlyCustomerLoyalty.empty()) {
+    if (all_of(monthlyCustomerLoyalty.months.begin(), monthlyCustomerLoyalty.months.end(),
+               [](const auto& month) { return month.empty(); })) {
         cout << "\n[LOYAL CUSTOMER REPORT] No 'DONE' sales data found for store " << this->storeName << ".\n\n";
         return;
     }
@@ -259,9 +412,10 @@ void Seller::handleLoyalCustomerReport() {
     cout << "\n=== MOST LOYAL CUSTOMERS PER MONTH (" << this->storeName << ") ===\n";
     cout << "(Based on number of DONE orders)\n";
 
-    for (const auto& monthPair : monthlyCustomerLoyalty) {
-        const string& month = monthPair.first;
-        const auto& customerData = monthPair.second;
+    for (size_t slot = 0; slot < monthlyCustomerLoyalty.months.size(); ++slot) {
+        if (monthlyCustomerLoyalty.months[slot].empty()) continue;
+        string month = monthKeyName(monthlyCustomerLoyalty.firstMonth + static_cast<int32_t>(slot));
+        map<string, int> customerData = namedCounts(monthlyCustomerLoyalty.months[slot]);
 
         string topCustomerName = "N/A";
         int maxOrders = 0;
@@ -343,7 +497,7 @@ void Seller::handleStoreCapabilitiesMenu() {
                     break;
                 }
                 // Call global analytics function
-                showRecentTransactions(orders, nDays); 
+                showRecentTransactions(nDays); 
                 break;
             }
             case 4: {
@@ -355,7 +509,7 @@ void Seller::handleStoreCapabilitiesMenu() {
                     break;
                 }
                 // Call global analytics function
-                viewMostActiveBuyersPerDay(orders, nBuyers, 10); 
+                viewMostActiveBuyersPerDay(nBuyers, 10); 
                 break;
             }
             case 5:
@@ -366,7 +520,7 @@ void Seller::handleStoreCapabilitiesMenu() {
                     std::cin.clear(); std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     break;
                 }
-                viewMostActiveSellersPerDay(orders, nSellers, 10);
+                viewMostActiveSellersPerDay(nSellers, 10);
                 break;
             case 6:
                 handlePopularItemsReport();
@@ -16,16 +16,20 @@
 class Item;
 class BankCustomer;
 class Order;
+struct StoreSales;
 
 using namespace std;
 
 class Seller : public User {
 private:
     string storeName;
-    vector<Item> items;
 
     vector<Order> loadAllOrders() const;
 
+    // Reports answered from the sales sketches on large stores.
+    void handleEstimatedPopularItemsReport(const StoreSales& sales) const;
+    void handleEstimatedLoyalCustomerReport(const StoreSales& sales) const;
+
 public:
     Seller(const string& name, const string& password, const string& storeName);
     
@@ -42,15 +46,22 @@ public:
     string inventoryToCSV() const;
     
     void addItem(int id, const string& name, int qty, double price);
-    void addItemObject(const Item& item) { items.push_back(item); }
+    void addItemObject(const Item& item);
     void showInventory() const;
     void removeItem(int id);
+    bool adjustItemQuantity(int itemId, int delta);
     
     void viewMostFrequentItems(int mItems) const;
     void viewOrders() const;
     void handleStoreCapabilitiesMenu();
 
     const string& getStoreName() const { return storeName; }
+    // The store's items, held by the inventory service.
+    const vector<Item>& getItems() const;
+
+    // True when an item was added, changed or removed since the last save.
+    bool isInventoryDirty() const;
+    void clearInventoryDirty();
     
     void handleAnalysisFunctionality();
     void handlePopularItemsReport();
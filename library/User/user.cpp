@@ -7,20 +7,29 @@
 #include "./user.h"
 #include "./buyer.h" 
 #include "./seller.h" 
+#include "./user_directory.h"
 #include "../Bank/bank_customer.h"
 #include "../Item/item.h"
 #include "../Item/order.h"
+#include "../Item/order_index.h"
+#include "../Item/sales_sketch.h"
 #include "../Item/analytics.h"
 #include "../Bank/bank.h"
+#include "../Serialization/serialization.h"
 
 using namespace std;
 
 vector<shared_ptr<User>> users;
+UserDirectory userDirectory(users);
 vector<Order> orders;
+OrderIndex orderIndex(orders);
+SalesSketches salesSketches(orders);
 shared_ptr<User> currentUser = nullptr;
 
 extern Bank systemBank;
 
+const int MAX_ACCOUNT_ID_ATTEMPTS = 10;
+
 shared_ptr<User> loginUser() {
     string inputName;
     string inputPassword;
@@ -31,17 +40,12 @@ shared_ptr<User> loginUser() {
     cout << "Enter Your Password: ";
     cin >> inputPassword;
 
-    for (const auto& user : users) {
-        if (user->getName() == inputName) {
-            if (user->getPassword() == inputPassword) {
-                return user;
-            } else {
-                cout << "Incorrect password.\n";
-                return nullptr;
-            }
-        }
+    auto user = userDirectory.findByName(inputName);
+    if (user && user->getPassword() != inputPassword) {
+        cout << "Incorrect password.\n";
+        return nullptr;
     }
-    return nullptr;
+    return user;
 }
 
 void handleRegister() {
@@ -79,25 +83,36 @@ void handleRegister() {
             cout << "Enter Password: ";
             getline(cin, inputPassword);
 
-            auto it = find_if(users.begin(), users.end(), 
-                              [&](const shared_ptr<User>& u) {
-                                  return u->getName() == inputName;
-                              });
+            shared_ptr<User> existingUser = userDirectory.findByName(inputName);
 
             if (choice == 1) {
-                if (it != users.end()) {
+                if (existingUser) {
                     cout << "Failed. Use another name to register\n\n";
                     continue;
                 }
-                users.push_back(make_shared<Buyer>(inputName, inputPassword)); 
+                // Account ids are drawn at random; a taken one is drawn again.
+                auto newBuyer = make_shared<Buyer>(inputName, inputPassword);
+                for (int attempt = 1; !systemBank.registerCustomer(newBuyer->getAccount()); ++attempt) {
+                    cout << "Bank account ID " << newBuyer->getAccount()->getId() << " is already in use.\n";
+                    if (attempt == MAX_ACCOUNT_ID_ATTEMPTS) {
+                        newBuyer = nullptr;
+                        break;
+                    }
+                    newBuyer = make_shared<Buyer>(inputName, inputPassword);
+                }
+                if (!newBuyer) {
+                    cout << "Failed. No free bank account ID was found, please try again.\n\n";
+                    continue;
+                }
+                userDirectory.put(newBuyer);
+                logUserUpsert(*newBuyer);
                 cout << "Buyer account for " << inputName << " created successfully.\n\n";  
             
             } else if (choice == 2) {
-                if (it == users.end()) {
+                if (!existingUser) {
                     cout << "Failed. Buyer not found\n\n";
                     continue;
                 }
-                shared_ptr<User> existingUser = *it;
 
                 if (existingUser->getPassword() != inputPassword) {
                     cout << "Failed. Wrong Password\n\n";
@@ -111,13 +126,19 @@ void handleRegister() {
 
                 cout << "Enter Store Name: ";
                 getline(cin, inputStoreName);
+
+                if (userDirectory.findByStore(inputStoreName)) {
+                    cout << "Failed. Store name already taken\n\n";
+                    continue;
+                }
                 
                 shared_ptr<BankCustomer> existingAccount = existingUser->getAccount();
 
                 shared_ptr<Seller> newSeller = make_shared<Seller>(
                     inputName, inputPassword, inputStoreName, existingAccount);
 
-                *it = newSeller; 
+                userDirectory.put(newSeller);
+                logUserUpsert(*newSeller);
                 
                 cout << "Success. Account already upgraded to be seller.\n\n";
             }
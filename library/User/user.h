@@ -13,6 +13,7 @@ class BankCustomer;
 class User {
 private:
     string name;
+    bool dirty;
 
 protected:
     string password;
@@ -20,10 +21,10 @@ protected:
 
 public:
     User(const string& uname, const string& upass) 
-        : name(uname), password(upass), account(nullptr) {}
+        : name(uname), dirty(true), password(upass), account(nullptr) {}
 
     User(const string& uname, const string& upass, shared_ptr<BankCustomer> acc) 
-        : name(uname), password(upass), account(acc) {}
+        : name(uname), dirty(true), password(upass), account(acc) {}
 
     virtual ~User() = default; 
 
@@ -31,6 +32,10 @@ public:
     const string& getPassword() const { return password; }
     shared_ptr<BankCustomer> getAccount() const { return account; } 
 
+    // New users start dirty; the loader clears the flag for stored ones.
+    bool isDirty() const { return dirty; }
+    void clearDirty() { dirty = false; }
+
     virtual bool isAdmin() const { return false; } 
     virtual bool isSeller() const { return false; }
 
@@ -0,0 +1,64 @@
+#include "./user_directory.h"
+#include "../Serialization/snapshot_files.h"
+
+using namespace std;
+
+UserDirectory::UserDirectory(vector<shared_ptr<User>>& users) : users(users) {}
+
+void UserDirectory::clear() {
+    users.clear();
+    byName.clear();
+    byStore.clear();
+}
+
+void UserDirectory::reserve(size_t n) {
+    users.reserve(n);
+    byName.reserve(n);
+}
+
+void UserDirectory::indexStore(const shared_ptr<User>& user) {
+    if (auto seller = dynamic_pointer_cast<Seller>(user)) {
+        byStore[seller->getStoreName()] = seller;
+    }
+}
+
+// New users and accounts start dirty without being listed, so they are
+// listed here.
+void UserDirectory::markNew(const shared_ptr<User>& user) {
+    if (user->isDirty()) dirtyUsers.mark(user->getName());
+    auto account = user->getAccount();
+    if (account && account->isDirty()) dirtyAccounts.mark(account->getName());
+}
+
+void UserDirectory::put(const shared_ptr<User>& user) {
+    if (!user) return;
+    markNew(user);
+
+    auto found = byName.find(user->getName());
+    if (found == byName.end()) {
+        byName.emplace(user->getName(), users.size());
+        users.push_back(user);
+        indexStore(user);
+        return;
+    }
+
+    shared_ptr<User>& slot = users[found->second];
+    if (auto previous = dynamic_pointer_cast<Seller>(slot)) {
+        auto store = byStore.find(previous->getStoreName());
+        if (store != byStore.end() && store->second == previous) {
+            byStore.erase(store);
+        }
+    }
+    slot = user;
+    indexStore(user);
+}
+
+shared_ptr<User> UserDirectory::findByName(const string& name) const {
+    auto found = byName.find(name);
+    return found == byName.end() ? nullptr : users[found->second];
+}
+
+shared_ptr<Seller> UserDirectory::findByStore(const string& storeName) const {
+    auto found = byStore.find(storeName);
+    return found == byStore.end() ? nullptr : found->second;
+}
@@ -0,0 +1,43 @@
+#ifndef USER_DIRECTORY_H
+#define USER_DIRECTORY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "./user.h"
+#include "./seller.h"
+
+using namespace std;
+
+// Hash indexes over the global user list, by user name and by store name.
+// Users are added and replaced through the directory so the indexes never
+// go stale; a user's position in the list does not change.
+class UserDirectory {
+private:
+    vector<shared_ptr<User>>& users;
+    unordered_map<string, size_t> byName;
+    unordered_map<string, shared_ptr<Seller>> byStore;
+
+    void indexStore(const shared_ptr<User>& user);
+    void markNew(const shared_ptr<User>& user);
+
+public:
+    explicit UserDirectory(vector<shared_ptr<User>>& users);
+
+    // Empties the user list and the indexes.
+    void clear();
+    void reserve(size_t n);
+
+    // Replaces the user with the same name in place, as when a buyer is
+    // upgraded to a seller, or appends a new one.
+    void put(const shared_ptr<User>& user);
+
+    shared_ptr<User> findByName(const string& name) const;
+    shared_ptr<Seller> findByStore(const string& storeName) const;
+};
+
+extern UserDirectory userDirectory;
+
+#endif // USER_DIRECTORY_H
@@ -2,12 +2,16 @@
 #include <memory>
 #include <vector>
 #include <limits>
+#include <string>
+#include <charconv>
 
 #include "./library/User/buyer.h"
 #include "./library/User/seller.h"
 #include "./library/User/user.h"
 #include "./library/Bank/bank.h"
 #include "./library/Serialization/serialization.h"
+#include "./library/Item/sales_sketch.h"
+#include "./library/Item/parallel_reduce.h"
 
 using namespace std;
 
@@ -25,7 +29,75 @@ shared_ptr<User> loginUser();
 void handleRegister();
 void handleLoginMenu();
 
-int main() {
+// Reads the positive count of a --name=N option; anything else is rejected.
+bool parseCount(const string& value, size_t& count) {
+    size_t parsed = 0;
+    auto result = from_chars(value.data(), value.data() + value.size(), parsed);
+    if (result.ec != errc() || result.ptr != value.data() + value.size() || parsed == 0) return false;
+    count = parsed;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SketchSettings sketches;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--orders=columnar") {
+            setOrderFileFormat(ORDERS_COLUMNAR);
+        } else if (arg.rfind("--journal=", 0) == 0) {
+            JournalSettings journal;
+            string mode = arg.substr(10);
+            if (mode == "none") {
+                journal.durability = DURABILITY_NONE;
+            } else if (mode == "flush") {
+                journal.durability = DURABILITY_FLUSH;
+            } else if (mode == "fsync") {
+                journal.durability = DURABILITY_FSYNC;
+            } else {
+                cerr << "Error: Unknown journal mode '" << mode << "' (use none, flush or fsync).\n";
+                return 1;
+            }
+            setJournalSettings(journal);
+        } else if (arg.rfind("--topk=", 0) == 0) {
+            string mode = arg.substr(7);
+            if (mode == "auto") {
+                sketches.mode = TOPK_AUTO;
+            } else if (mode == "exact") {
+                sketches.mode = TOPK_EXACT;
+            } else if (mode == "approx") {
+                sketches.mode = TOPK_APPROX;
+            } else {
+                cerr << "Error: Unknown top-k mode '" << mode << "' (use auto, exact or approx).\n";
+                return 1;
+            }
+        } else if (arg.rfind("--sketch-counters=", 0) == 0) {
+            if (!parseCount(arg.substr(18), sketches.counters)) {
+                cerr << "Error: --sketch-counters needs a positive number.\n";
+                return 1;
+            }
+        } else if (arg.rfind("--history=", 0) == 0) {
+            size_t entries = 0;
+            if (!parseCount(arg.substr(10), entries)) {
+                cerr << "Error: --history needs a positive number.\n";
+                return 1;
+            }
+            TransactionHistory::setDefaultCapacity(entries);
+        } else if (arg.rfind("--sketch-width=", 0) == 0) {
+            if (!parseCount(arg.substr(15), sketches.width)) {
+                cerr << "Error: --sketch-width needs a positive number.\n";
+                return 1;
+            }
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            size_t threads = 0;
+            if (!parseCount(arg.substr(10), threads)) {
+                cerr << "Error: --threads needs a positive number.\n";
+                return 1;
+            }
+            setAnalyticsThreads(threads);
+        }
+    }
+    salesSketches.configure(sketches);
+
     loadAllData(users, orders);
 
     int choice;